@@ -4,7 +4,7 @@ import sys
 import tempfile
 from pathlib import Path
 
-from flask import Blueprint, abort, jsonify, request, send_from_directory
+from flask import Blueprint, Response, abort, jsonify, request, send_from_directory
 
 bp = Blueprint("main", __name__)
 
@@ -69,12 +69,15 @@ def process_file():
         out_path = os.path.join(tmpdir, f"{stem}.json")
 
         # Run the full pipeline: instrument → compile → run → normalize
-        return_code = deal(src_path, output=out_path, seed=-1)
+        timings = {}
+        return_code = deal(src_path, output=out_path, seed=-1, timings=timings)
 
         # Read the result
         with open(out_path) as f:
             result = json.load(f)
 
+    from metrics import REGISTRY
+    REGISTRY.observe(timings, success=result.get("success", False))
     return jsonify(result)
 
 
@@ -124,14 +127,19 @@ def process_code_files():
         try:
             with tempfile.TemporaryDirectory() as tmpdir:
                 output_path = Path(tmpdir) / f"{input_path.stem}.json"
-                
+
                 # Run the parser
-                return_code = deal(str(input_path), output=str(output_path), seed=-1)
-                
+                timings = {}
+                return_code = deal(str(input_path), output=str(output_path), seed=-1,
+                                   timings=timings)
+
                 # Read the result
                 with open(output_path) as f:
                     result = json.load(f)
 
+                from metrics import REGISTRY
+                REGISTRY.observe(timings, success=result.get("success", False))
+
                 if result.get("success", False):
                     # Save to data/json directory
                     JSON_DIR.mkdir(parents=True, exist_ok=True)
@@ -175,6 +183,94 @@ def process_code_files():
     })
 
 
+@bp.route("/api/jobs", methods=["POST"])
+def submit_job():
+    """Enqueue pipeline processing for an uploaded file (async
+    /api/process-file); responds immediately with the job id."""
+    if "file" not in request.files:
+        return jsonify({"success": False, "error": {"stage": "upload", "message": "No file provided"}}), 400
+
+    file = request.files["file"]
+    if not file.filename:
+        return jsonify({"success": False, "error": {"stage": "upload", "message": "No file selected"}}), 400
+
+    ext = os.path.splitext(file.filename)[1].lower()
+    if ext not in ALLOWED_EXTENSIONS:
+        return jsonify({"success": False, "error": {"stage": "upload", "message": f"Unsupported file type '{ext}'. Only .c and .py files are accepted."}}), 400
+
+    from jobs import QUEUE
+
+    # The request body is gone once the handler returns — read it now,
+    # the worker thread writes its own copy.
+    filename = os.path.basename(file.filename)
+    src_bytes = file.read()
+
+    def run_job(progress):
+        from run import deal
+        from metrics import REGISTRY
+
+        timings = {}
+        with tempfile.TemporaryDirectory() as tmpdir:
+            src_path = os.path.join(tmpdir, filename)
+            with open(src_path, "wb") as f:
+                f.write(src_bytes)
+            out_path = os.path.join(tmpdir, f"{os.path.splitext(filename)[0]}.json")
+            deal(src_path, output=out_path, seed=-1,
+                 timings=timings, progress=progress)
+            with open(out_path) as f:
+                result = json.load(f)
+        REGISTRY.observe(timings, success=result.get("success", False))
+        return result
+
+    return jsonify({"job_id": QUEUE.submit(run_job, label=filename)}), 202
+
+
+def _job_public_state(snapshot, with_result):
+    state = {k: snapshot[k] for k in
+             ("id", "label", "state", "stage", "stages_done", "error")}
+    if with_result and snapshot["state"] == "done":
+        state["result"] = snapshot["result"]
+    return state
+
+
+@bp.route("/api/jobs/<job_id>")
+def job_status(job_id):
+    """Job state for polling clients; carries the result once done."""
+    from jobs import QUEUE
+    snapshot = QUEUE.status(job_id)
+    if snapshot is None:
+        abort(404)
+    return jsonify(_job_public_state(snapshot, with_result=True))
+
+
+@bp.route("/api/jobs/<job_id>/events")
+def job_events(job_id):
+    """SSE feed of the job's stage transitions.
+
+    One `data:` event per transition (result only on the final one, so
+    progress events stay tiny), ending when the job is done or failed.
+    """
+    from jobs import QUEUE
+    if QUEUE.status(job_id) is None:
+        abort(404)
+
+    def generate():
+        for snapshot in QUEUE.events(job_id):
+            terminal = snapshot["state"] in ("done", "error")
+            yield f"data: {json.dumps(_job_public_state(snapshot, with_result=terminal))}\n\n"
+
+    return Response(generate(), mimetype="text/event-stream",
+                    headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"})
+
+
+@bp.route("/api/metrics")
+def get_metrics():
+    """Pipeline stage timings and sizes, Prometheus text format."""
+    from metrics import REGISTRY
+    return Response(REGISTRY.render(),
+                    mimetype="text/plain; version=0.0.4; charset=utf-8")
+
+
 @bp.route("/")
 def index():
     return send_from_directory(STATIC_DIR, "index.html")
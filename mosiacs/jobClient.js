@@ -0,0 +1,135 @@
+/**
+ * jobClient — async pipeline processing with progress.
+ *
+ * Wraps the server's job API: POST /api/jobs enqueues the file and
+ * returns immediately, then the job's SSE feed streams stage-by-stage
+ * progress until the pipeline finishes. Replaces direct calls to
+ * /api/process-file, which held the request open for the whole
+ * instrument→compile→run→normalize pipeline.
+ *
+ * processFileJob(file, onProgress) → Promise<result JSON>
+ *   onProgress (optional) is called with a human-readable stage label
+ *   ('Compiling…', 'Running…', …) on every transition.
+ *
+ * processFilesStream(files, onEntry) → Promise<totals>
+ *   Batch-processes files from the server's data/ directory over
+ *   /api/process-stream; onEntry fires per completed file.
+ */
+
+const JOB_STAGE_LABELS = {
+    queued: 'Queued…',
+    instrument: 'Instrumenting…',
+    compile: 'Compiling…',
+    run: 'Running…',
+    normalize: 'Normalizing…',
+    emit: 'Writing trace…',
+};
+
+async function processFileJob(file, onProgress) {
+    const formData = new FormData();
+    formData.append('file', file);
+
+    const submit = await fetch('/api/jobs', { method: 'POST', body: formData });
+    const submitted = await submit.json();
+    if (!submit.ok || !submitted.job_id) {
+        throw new Error((submitted.error && submitted.error.message) || 'Job submission failed');
+    }
+    const jobId = submitted.job_id;
+
+    return new Promise((resolve, reject) => {
+        const source = new EventSource(`/api/jobs/${jobId}/events`);
+        let settled = false;
+
+        const finish = (job) => {
+            settled = true;
+            source.close();
+            if (job.state === 'done') resolve(job.result);
+            else reject(new Error(job.error || 'Processing failed'));
+        };
+
+        source.onmessage = (event) => {
+            const job = JSON.parse(event.data);
+            if (job.state === 'done' || job.state === 'error') {
+                finish(job);
+            } else if (onProgress) {
+                onProgress(JOB_STAGE_LABELS[job.stage || job.state] || 'Processing…');
+            }
+        };
+
+        // SSE dropped (proxy, network) — fall back to polling the job.
+        source.onerror = () => {
+            if (settled) return;
+            source.close();
+            const poll = setInterval(async () => {
+                try {
+                    const res = await fetch(`/api/jobs/${jobId}`);
+                    if (!res.ok) throw new Error(`Job lookup failed (${res.status})`);
+                    const job = await res.json();
+                    if (job.state === 'done' || job.state === 'error') {
+                        clearInterval(poll);
+                        finish(job);
+                    } else if (onProgress) {
+                        onProgress(JOB_STAGE_LABELS[job.stage || job.state] || 'Processing…');
+                    }
+                } catch (err) {
+                    clearInterval(poll);
+                    settled = true;
+                    reject(err);
+                }
+            }, 500);
+        };
+    });
+}
+
+/**
+ * Process a batch of files from the server's data/ directory.
+ *
+ * The server fans the batch out across its worker pool and streams one
+ * SSE event per completed file, so early finishers can render while the
+ * rest are still compiling. onEntry receives each event's
+ * { kind: 'result'|'error', entry } the moment it arrives; resolves
+ * with the final totals ({ processed, failed, total }).
+ *
+ * EventSource can't POST, so the SSE framing is parsed off a fetch
+ * stream: `event:`/`data:` lines, events separated by a blank line.
+ */
+async function processFilesStream(files, onEntry) {
+    const resp = await fetch('/api/process-stream', {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify({ files }),
+    });
+    if (!resp.ok || !resp.body) {
+        throw new Error(`Batch processing failed (${resp.status})`);
+    }
+
+    const reader = resp.body.getReader();
+    const decoder = new TextDecoder();
+    let buffer = '';
+    let totals = null;
+
+    const handleEvent = (raw) => {
+        let eventName = 'message';
+        const dataLines = [];
+        for (const line of raw.split('\n')) {
+            if (line.startsWith('event:')) eventName = line.slice(6).trim();
+            else if (line.startsWith('data:')) dataLines.push(line.slice(5).trim());
+        }
+        if (dataLines.length === 0) return;
+        const payload = JSON.parse(dataLines.join('\n'));
+        if (eventName === 'done') totals = payload;
+        else onEntry(payload);
+    };
+
+    for (;;) {
+        const { done, value } = await reader.read();
+        if (done) break;
+        buffer += decoder.decode(value, { stream: true });
+        let sep;
+        while ((sep = buffer.indexOf('\n\n')) !== -1) {
+            handleEvent(buffer.slice(0, sep));
+            buffer = buffer.slice(sep + 2);
+        }
+    }
+    return totals || { processed: 0, failed: 0, total: files.length };
+}
@@ -122,55 +122,93 @@ document.addEventListener('DOMContentLoaded', () => {
         try {
             const results = [];
             const errors = [];
+            let finished = 0;
+            let rendered = false;
 
-            // Process each file - always use /api/process-file like "save and run" does
-            for (const filename of selectedFiles) {
+            const updateLabel = () => {
+                loadBtn.textContent = `Processed ${finished}/${selectedFiles.length}…`;
+            };
+
+            // Render the first finished file the moment it arrives, so
+            // the city appears while the rest of the batch is still
+            // compiling instead of after the slowest file. When the
+            // server stored the trace, load it window by window instead
+            // of downloading the whole record array.
+            const accept = (filename, json, traceId) => {
+                finished++;
+                results.push({ file: filename });
+                if (!rendered) {
+                    rendered = true;
+                    visualizer.setSourceCode(null);
+                    if (traceId) visualizer.visualizeWindowed(traceId);
+                    else visualizer.visualize(json);
+                }
+                updateLabel();
+            };
+
+            const fail = (entry) => {
+                finished++;
+                errors.push(entry);
+                console.error(`Failed to process ${entry.file}:`, entry.message);
+                updateLabel();
+            };
+
+            // Process one file through the job queue (used for edited
+            // files and as the fallback when the batch stream is absent).
+            const runJob = async (filename, code) => {
                 try {
-                    let fileToProcess;
-                    
-                    // Check if we have a cached version
-                    const cachedCode = localStorage.getItem(`code_${filename}`);
-                    if (cachedCode) {
-                        // Use cached version
-                        const blob = new Blob([cachedCode], { type: 'text/plain' });
-                        fileToProcess = new File([blob], filename);
-                    } else {
-                        // Fetch from server and create a File object
+                    if (code === null) {
                         const fileResponse = await fetch(`/data/${filename}`);
-                        const fileText = await fileResponse.text();
-                        const blob = new Blob([fileText], { type: 'text/plain' });
-                        fileToProcess = new File([blob], filename);
+                        code = await fileResponse.text();
                     }
-                    
-                    // Process using /api/process-file (same as "save and run")
-                    const formData = new FormData();
-                    formData.append('file', fileToProcess);
-                    const response = await fetch('/api/process-file', { method: 'POST', body: formData });
-                    const json = await response.json();
-                    
-                    // Always accept and visualize (same as "save and run")
-                    results.push({ file: filename, data: json });
+                    const blob = new Blob([code], { type: 'text/plain' });
+                    const json = await processFileJob(new File([blob], filename), () => {});
+                    accept(filename, json, json.trace_id);
                 } catch (err) {
-                    console.error(`Failed to process ${filename}:`, err);
+                    fail({ file: filename, stage: 'processing', message: err.message });
                 }
+            };
+
+            // Files edited in the browser exist only in localStorage, so
+            // they go through the upload job queue; untouched files are
+            // processed from data/ by the server-side pool in a single
+            // streamed batch that completes out of order.
+            const editedFiles = selectedFiles.filter(f => localStorage.getItem(`code_${f}`) !== null);
+            const serverFiles = selectedFiles.filter(f => localStorage.getItem(`code_${f}`) === null);
+
+            const tasks = editedFiles.map(f => runJob(f, localStorage.getItem(`code_${f}`)));
+
+            if (serverFiles.length > 0) {
+                const streamed = new Set();
+                tasks.push(
+                    processFilesStream(serverFiles, ({ kind, entry }) => {
+                        streamed.add(entry.file);
+                        if (kind === 'result') accept(entry.file, entry.data, entry.output);
+                        else fail(entry);
+                    }).catch(err => {
+                        // Stream endpoint unavailable or dropped — fall
+                        // back to concurrent per-file jobs for whatever
+                        // the stream didn't deliver.
+                        console.warn('Batch stream unavailable, using per-file jobs:', err.message);
+                        const remaining = serverFiles.filter(f => !streamed.has(f));
+                        return Promise.all(remaining.map(f => runJob(f, null)));
+                    })
+                );
             }
 
-            // Always visualize if we got any results (same as "save and run")
+            await Promise.all(tasks);
+
             if (results.length > 0) {
                 const resultMsg = `Successfully processed ${results.length} file(s)`;
-                
+
                 if (errors.length > 0) {
-                    const errorDetails = errors.map(e => 
+                    const errorDetails = errors.map(e =>
                         `  • ${e.file}: [${e.stage}] ${e.message}`
                     ).join('\n');
                     console.log(`${resultMsg}\n\nErrors:\n${errorDetails}`);
                 } else {
                     console.log(resultMsg);
                 }
-
-                // Visualize the first successful result
-                visualizer.setSourceCode(null);
-                visualizer.visualize(results[0].data);
             }
         } catch (err) {
             console.error('Processing failed: ' + err.message);
@@ -9,10 +9,15 @@
  * the visualizer understands.
  */
 class CodeParser {
+    /** Trace fields that v2 output dictionary-codes (must match normalize.py). */
+    static INTERNED_FIELDS = ['subject', 'subtype', 'operator', 'label', 'condition', 'address'];
+
     constructor() {
         this.executionTrace = [];
         this.metadata = null;
         this.error = null;
+        // Server-side def-use chain index (see normalize.py CausalityIndex)
+        this.causality = null;
     }
 
     /**
@@ -21,20 +26,26 @@ class CodeParser {
      * @returns {Array} Parsed execution steps
      */
     parse(jsonData) {
-        const data = typeof jsonData === 'string' ? JSON.parse(jsonData) : jsonData;
+        const data = CodeParser.decode(
+            typeof jsonData === 'string' ? JSON.parse(jsonData) : jsonData
+        );
 
         // Check for compilation/runtime errors
         if (data.success === false && data.error) {
             this.error = {
                 stage: data.error.stage,
                 message: data.error.message,
-                line: this._extractErrorLine(data.error.message)
+                line: this._extractErrorLine(data.error.message),
+                // Timed-out runs still carry the trace captured before
+                // the kill; the error banner is informational, not fatal.
+                partial: data.error.partial === true
             };
         } else {
             this.error = null;
         }
 
         this.metadata = data.metadata || null;
+        this.causality = data.causality || null;
 
         // Normalize metadata: convert string numbers to actual numbers
         if (this.metadata) {
@@ -66,32 +77,90 @@ class CodeParser {
         const sourceFile = this.metadata?.file_name || 'unknown';
         const traces = data.traces || [];
 
-        this.executionTrace = traces.map((t, index) => {
-            return {
-                step:       index,
-                type:       t.type,                          // CALL, DECL, LOOP, ASSIGN, RETURN, CONDITION, BRANCH, READ, EXTERNAL_CALL, UNKNOWN
-                name:       t.subject || '',                 // primary identifier
-                value:      t.value !== undefined ? String(t.value) : '',
-                address:    t.address || '0',
-                line:       Number(t.line_number) || 0,      // ensure numeric
-                depth:      Number(t.stack_depth) || 0,      // ensure numeric
-                // New fields from JSON
-                subtype:    t.subtype || '',                 // e.g. "for", "else", "literal"
-                condition:  t.condition || '',               // e.g. "i<5", "sum < 10"
-                conditionResult: t.condition_result !== undefined ? Number(t.condition_result) : null,
-                // READ-specific: the value that was read (format_spec in the raw trace)
-                readValue:  t.format_spec !== undefined ? String(t.format_spec) : '',
-                // Multi-file support
-                sourceFile: sourceFile,                      // which file this step is from
-                id:         t.id,                            // trace event ID
-                args:       t.args || [],                    // for UNKNOWN events
-                raw:        t
-            };
-        });
+        this.executionTrace = traces.map((t, index) => this._toStep(t, index, sourceFile));
 
         return this.executionTrace;
     }
 
+    /**
+     * Normalize a window of raw trace records into step objects.
+     * Used by the windowed loading path (/api/trace/<id>/slice) where
+     * records arrive in batches; `baseIndex` is the window's offset into
+     * the full trace so step numbers stay globally consistent.
+     * @param {Array<object>} rawTraces – raw records from a slice response
+     * @param {number} baseIndex – absolute index of the first record
+     * @returns {Array} Parsed execution steps
+     */
+    parseSteps(rawTraces, baseIndex = 0) {
+        const sourceFile = this.metadata?.file_name || 'unknown';
+        return (rawTraces || []).map((t, i) => this._toStep(t, baseIndex + i, sourceFile));
+    }
+
+    /** Map one raw trace record to the step shape the visualizer uses. */
+    _toStep(t, index, sourceFile) {
+        return {
+            step:       index,
+            type:       t.type,                          // CALL, DECL, LOOP, ASSIGN, RETURN, CONDITION, BRANCH, READ, EXTERNAL_CALL, UNKNOWN
+            name:       t.subject || '',                 // primary identifier
+            value:      t.value !== undefined ? String(t.value) : '',
+            address:    t.address || '0',
+            line:       Number(t.line_number) || 0,      // ensure numeric
+            depth:      Number(t.stack_depth) || 0,      // ensure numeric
+            // New fields from JSON
+            subtype:    t.subtype || '',                 // e.g. "for", "else", "literal"
+            condition:  t.condition || '',               // e.g. "i<5", "sum < 10"
+            conditionResult: t.condition_result !== undefined ? Number(t.condition_result) : null,
+            // READ-specific: the value that was read (format_spec in the raw trace)
+            readValue:  t.format_spec !== undefined ? String(t.format_spec) : '',
+            // LOOP_AGG-specific: exact iteration count from the sampling runtime
+            iterations: t.iterations !== undefined ? Number(t.iterations) : null,
+            // ADDR-specific: object size behind an interned address token
+            size:       t.size !== undefined ? Number(t.size) : null,
+            // Precomputed nesting (normalize.py CallTreeIndex): id of the
+            // innermost enclosing scope node, and — on scope-opening
+            // records — the id of the node this record opens
+            scope:      t.scope !== undefined ? Number(t.scope) : null,
+            node:       t.node !== undefined ? Number(t.node) : null,
+            // RUN-specific (folded repetitive records): original type,
+            // record count, and per-record field deltas for lazy expansion
+            runOf:      t.of || null,
+            count:      t.count !== undefined ? Number(t.count) : null,
+            deltas:     t.deltas || null,
+            // Multi-file support
+            sourceFile: sourceFile,                      // which file this step is from
+            id:         t.id,                            // trace event ID
+            args:       t.args || [],                    // for UNKNOWN events
+            raw:        t
+        };
+    }
+
+    /**
+     * Resolve a v2 dictionary-coded trace JSON back to plain strings.
+     *
+     * v2 output interns heavily repeated fields (names, conditions,
+     * addresses) into a `strings` table and stores indices in the records;
+     * v1 objects pass through untouched.
+     * @param {object} data – raw trace JSON (v1 or v2)
+     * @returns {object} trace JSON with all string fields resolved
+     */
+    static decode(data) {
+        if (!data || data.version !== 2 || !Array.isArray(data.strings)) {
+            return data;
+        }
+        const strings = data.strings;
+        const traces = data.traces || [];
+        for (const t of traces) {
+            for (const field of CodeParser.INTERNED_FIELDS) {
+                if (typeof t[field] === 'number') {
+                    t[field] = strings[t[field]];
+                }
+            }
+        }
+        delete data.version;
+        delete data.strings;
+        return data;
+    }
+
     /**
      * Extract the first line number from a compilation error message.
      * @param {string} message - The error message
@@ -129,6 +198,37 @@ class CodeParser {
             });
     }
 
+    /**
+     * Fetch the summary of a stored trace (metadata, per-type counts,
+     * function table) without downloading any trace records.
+     * @param {string} traceId – stored JSON name (with or without .json)
+     * @returns {Promise<object>} The summary object
+     */
+    static getTraceSummary(traceId) {
+        return fetch(`/api/trace/${traceId}/summary`)
+            .then(res => {
+                if (!res.ok) throw new Error(`Failed to load trace summary: ${res.status}`);
+                return res.json();
+            });
+    }
+
+    /**
+     * Fetch one window of trace records from a stored trace.
+     * Interned fields arrive already resolved, so the records plug
+     * straight into parseSteps().
+     * @param {string} traceId – stored JSON name (with or without .json)
+     * @param {number} start – absolute index of the first record
+     * @param {number} count – number of records to fetch
+     * @returns {Promise<object>} { start, count, total, traces }
+     */
+    static getTraceSlice(traceId, start, count) {
+        return fetch(`/api/trace/${traceId}/slice?start=${start}&count=${count}`)
+            .then(res => {
+                if (!res.ok) throw new Error(`Failed to load trace slice: ${res.status}`);
+                return res.json();
+            });
+    }
+
     /**
      * Upload a source file (.c or .py) to the server for processing.
      * @param {File} file – the File object from an <input type="file">
@@ -166,7 +266,8 @@ class CodeParser {
         };
 
         // Concatenate traces, adding file context to each trace event
-        jsonArray.forEach(json => {
+        jsonArray.forEach(rawJson => {
+            const json = CodeParser.decode(rawJson);
             const fileName = json.metadata?.file_name || 'unknown';
             const traces = json.traces || [];
             traces.forEach(t => {
@@ -31,14 +31,19 @@ const SPIRAL_CONFIG = {
  * The arc length traveled each step stays constant — the angle shrinks as
  * the radius grows, keeping the spiral visually round.
  */
+const _spiralAngleCache = [0];
+
 function getSpiralAngle(slot) {
     const { radiusStart, radiusGrowth, angleStep } = SPIRAL_CONFIG;
     const arcBase = radiusStart * angleStep;
-    let angle = 0;
-    for (let i = 0; i < slot; i++) {
-        angle += arcBase / (radiusStart + i * radiusGrowth);
+    // The angle is a prefix sum over slots, so the cache extends
+    // incrementally — re-summing from zero per call made every render
+    // pass quadratic in city size.
+    for (let i = _spiralAngleCache.length; i <= slot; i++) {
+        _spiralAngleCache[i] =
+            _spiralAngleCache[i - 1] + arcBase / (radiusStart + (i - 1) * radiusGrowth);
     }
-    return angle;
+    return _spiralAngleCache[slot];
 }
 
 /**
@@ -26,6 +26,12 @@ class CodeVisualizer {
 
         // Source code for the code panel
         this._sourceCode = null;
+
+        // Layout worker (lazy): parsing and spiral layout off the UI
+        // thread. undefined = not tried yet, null = unavailable.
+        this._layoutWorker = undefined;
+        this._workerJobs = new Map();   // job id → { resolve, reject }
+        this._workerJobId = 0;
     }
 
     /**
@@ -71,58 +77,141 @@ class CodeVisualizer {
         return this;
     }
 
-    /**
-     * Load and visualise a code trace.
-     */
-    visualize(codeTrace) {
-        // Clear previous city and code panel
-        this.cityRenderer.clear();
-        this._removeCodePanel();
+    // ─── Layout worker plumbing ───────────────────────────────────
 
-        // Clear any existing error notification
-        const errorPanel = document.getElementById('errorNotification');
-        if (errorPanel) {
-            errorPanel.remove();
+    _getLayoutWorker() {
+        if (this._layoutWorker === undefined) {
+            try {
+                this._layoutWorker = new Worker('visualizer/world/LayoutWorker.js');
+                this._layoutWorker.onmessage = (e) => this._onWorkerMessage(e.data);
+                this._layoutWorker.onerror = () => this._failWorkerJobs();
+            } catch (e) {
+                this._layoutWorker = null;
+            }
         }
+        return this._layoutWorker;
+    }
 
-        // Clear any active galaxy warp
-        if (this.galaxyWarpManager) {
-            this.galaxyWarpManager.clear();
+    _onWorkerMessage(msg) {
+        if (!msg) return;
+        if (msg.type === 'progress') {
+            if (msg.total) this._setProgress(msg.done / msg.total);
+            return;
         }
-
-        // Clear causality web
-        if (this.causalityRenderer) {
-            this.causalityRenderer.clear();
+        const job = this._workerJobs.get(msg.id);
+        if (job) {
+            this._workerJobs.delete(msg.id);
+            job.resolve(msg);
         }
+    }
 
-        // Clear panoramic render
-        if (this.panoramicRenderer) {
-            this.panoramicRenderer.clear();
+    _failWorkerJobs() {
+        // A broken worker (load error, CSP, file://) must not strand
+        // callers — reject everything so they take the sync fallback.
+        for (const [, job] of this._workerJobs) job.reject(new Error('layout worker failed'));
+        this._workerJobs.clear();
+        this._layoutWorker = null;
+    }
+
+    _workerRequest(msg, transfer) {
+        const worker = this._getLayoutWorker();
+        if (!worker) return Promise.reject(new Error('no layout worker'));
+        return new Promise((resolve, reject) => {
+            const id = ++this._workerJobId;
+            this._workerJobs.set(id, { resolve, reject });
+            worker.postMessage({ ...msg, id }, transfer || []);
+        });
+    }
+
+    /**
+     * Ask the worker for the spiral position table covering every slot
+     * the upcoming render will occupy (entities claim a stride of slots
+     * each, so this is the renderer's post-assignment slot count, not
+     * the entity count) and hand it to the renderer. Purely an
+     * accelerator: on any failure the renderer computes positions on
+     * the fly as before.
+     */
+    async _precomputeLayout(keys) {
+        const count = this.cityRenderer.slotCountAfter(keys);
+        if (count < 1) return;
+        try {
+            const res = await this._workerRequest({ type: 'layout', count });
+            this.cityRenderer.setPositionTable(res.positions, res.count);
+        } catch (e) {
+            /* sync fallback */
         }
+    }
 
-        // Clear sequencer
-        if (this.sequencerRenderer) {
-            this.sequencerRenderer.clear();
+    /**
+     * Parse a raw trace in the worker, mirroring the results into
+     * this.parser; falls back to a synchronous parse.
+     */
+    async _parseTrace(codeTrace) {
+        try {
+            const res = await this._workerRequest({ type: 'parse', data: codeTrace });
+            this.parser.metadata = res.metadata;
+            this.parser.error = res.error;
+            this.parser.causality = res.causality;
+            this.parser.executionTrace = res.steps;
+            return res.steps;
+        } catch (e) {
+            return this.parser.parse(codeTrace);
         }
+    }
 
-        // Clear memory pool
-        if (this.memoryPoolRenderer) {
-            this.memoryPoolRenderer.clear();
+    _setProgress(fraction) {
+        let bar = document.getElementById('loadProgress');
+        if (fraction === null) {
+            if (bar) bar.remove();
+            return;
         }
+        if (!bar) {
+            bar = document.createElement('div');
+            bar.id = 'loadProgress';
+            bar.style.cssText = `
+                position: fixed;
+                top: 0; left: 0;
+                height: 3px;
+                width: 0%;
+                background: linear-gradient(90deg, #4fc3f7, #9b59b6);
+                box-shadow: 0 0 8px rgba(79, 195, 247, 0.8);
+                z-index: 10001;
+                transition: width 0.15s ease-out;
+            `;
+            document.body.appendChild(bar);
+        }
+        bar.style.width = `${Math.min(100, Math.round(fraction * 100))}%`;
+    }
 
-        // Parse the trace
-        const trace = this.parser.parse(codeTrace);
+    /**
+     * Load and visualise a code trace.
+     */
+    async visualize(codeTrace) {
+        this._clearForNewTrace();
+        this._setProgress(0.05);
+
+        // Parse the trace (in the layout worker when available)
+        const trace = await this._parseTrace(codeTrace);
 
         // Show error notification if there's an error
         if (this.parser.error) {
             this._showErrorNotification(this.parser.error);
         }
 
+        // Hand the server-side causality index to the web renderer
+        if (this.causalityRenderer) {
+            this.causalityRenderer.setPrecomputed(this.parser.causality);
+        }
+
         // Feed into world state (with error info if present)
         this.worldState.loadTrace(trace, this.parser.error);
 
         // Advance to the end so the full city is visible
         this.worldState.seekTo(trace.length - 1);
+        this._setProgress(0.5);
+
+        // Spiral layout for every upcoming slot, computed off-thread
+        await this._precomputeLayout(this.worldState.creationOrder);
 
         // Block material dirty notifications during bulk mesh creation
         // (major perf win for large traces)
@@ -145,6 +234,192 @@ class CodeVisualizer {
         if (this._sourceCode) {
             this._buildCodePanel(this._sourceCode);
         }
+
+        this._setProgress(null);
+    }
+
+    /**
+     * Differential re-visualisation for the edit-run-inspect loop.
+     *
+     * Re-running an edited file usually leaves everything before the
+     * edit's first divergent event identical — and entity keys with it.
+     * CityRenderer.render is idempotent per key, so skipping the full
+     * clear() means unchanged buildings keep their meshes, slots and
+     * camera framing; afterwards only the keys that vanished from the
+     * new trace are pruned. Falls back to a full visualize() when
+     * nothing is rendered yet.
+     */
+    async visualizeUpdate(codeTrace) {
+        if (!this.cityRenderer._lastSnapshot) {
+            return this.visualize(codeTrace);
+        }
+        this._setProgress(0.05);
+
+        const trace = await this._parseTrace(codeTrace);
+
+        const errorPanel = document.getElementById('errorNotification');
+        if (errorPanel) errorPanel.remove();
+        if (this.parser.error) {
+            this._showErrorNotification(this.parser.error);
+        }
+
+        if (this.causalityRenderer) {
+            this.causalityRenderer.setPrecomputed(this.parser.causality);
+        }
+
+        this.worldState.loadTrace(trace, this.parser.error);
+        this.worldState.seekTo(trace.length - 1);
+        this._setProgress(0.5);
+
+        await this._precomputeLayout(this.worldState.creationOrder);
+
+        const scene = this.sceneManager.getScene();
+        scene.blockMaterialDirtyMechanism = true;
+        this.cityRenderer.render(this.worldState.getSnapshot());
+        this.cityRenderer.pruneStale(new Set(this.worldState.creationOrder));
+        scene.blockMaterialDirtyMechanism = false;
+
+        this._updateStats(trace.length);
+        this._setProgress(null);
+    }
+
+    /**
+     * Load and visualise a stored trace window by window.
+     *
+     * Fetches the summary first (metadata only), then pulls record
+     * windows from /api/trace/<id>/slice and feeds each into the world
+     * state as it arrives — the first spiral turns appear after one
+     * window instead of waiting for the whole trace to download.
+     * CityRenderer.render is idempotent per entity key, so re-rendering
+     * after each window only creates the newly-arrived buildings.
+     *
+     * @param {string} traceId – stored JSON name (with or without .json)
+     * @param {number} windowSize – records per slice request
+     */
+    async visualizeWindowed(traceId, windowSize = 2000) {
+        this._clearForNewTrace();
+        await this._streamTraceWindows(traceId, windowSize, false);
+    }
+
+    /**
+     * Differential windowed re-visualisation — the stored-trace
+     * counterpart of visualizeUpdate(). Streams the re-run's windows
+     * without the full clear(), so unchanged buildings keep their
+     * meshes, slots and camera framing, then prunes the keys that
+     * vanished from the new trace.
+     */
+    async visualizeWindowedUpdate(traceId, windowSize = 2000) {
+        if (!this.cityRenderer._lastSnapshot) {
+            return this.visualizeWindowed(traceId, windowSize);
+        }
+        const errorPanel = document.getElementById('errorNotification');
+        if (errorPanel) errorPanel.remove();
+        await this._streamTraceWindows(traceId, windowSize, true);
+        this.cityRenderer.pruneStale(new Set(this.worldState.creationOrder));
+    }
+
+    /**
+     * Shared window-streaming loop behind visualizeWindowed and
+     * visualizeWindowedUpdate. `update` skips the first-window camera
+     * reset and code-panel rebuild (the caller is keeping both).
+     */
+    async _streamTraceWindows(traceId, windowSize, update) {
+        this._setProgress(0.02);
+
+        const summary = await CodeParser.getTraceSummary(traceId);
+        this.parser.metadata = summary.metadata || null;
+        // Slices don't carry the causality section — fall back to
+        // client-side link derivation on this path
+        if (this.causalityRenderer) this.causalityRenderer.setPrecomputed(null);
+        this.parser.error = (summary.success === false && summary.error)
+            ? {
+                stage: summary.error.stage,
+                message: summary.error.message,
+                line: this.parser._extractErrorLine(summary.error.message)
+              }
+            : null;
+
+        if (this.parser.error) {
+            this._showErrorNotification(this.parser.error);
+        }
+
+        this.worldState.loadTrace([], this.parser.error);
+
+        const scene = this.sceneManager.getScene();
+        const total = summary.total_events || 0;
+        let start = 0;
+        let firstWindow = true;
+
+        while (start < total) {
+            const slice = await CodeParser.getTraceSlice(traceId, start, windowSize);
+            if (!slice.traces || slice.traces.length === 0) break;
+
+            const steps = this.parser.parseSteps(slice.traces, slice.start);
+            this.worldState.appendTrace(steps);
+            this.worldState.seekTo(this.worldState.trace.length - 1);
+
+            await this._precomputeLayout(this.worldState.creationOrder);
+
+            // Same bulk-creation guard as visualize()
+            scene.blockMaterialDirtyMechanism = true;
+            this.cityRenderer.render(this.worldState.getSnapshot());
+            scene.blockMaterialDirtyMechanism = false;
+
+            if (firstWindow) {
+                firstWindow = false;
+                if (!update) {
+                    this.sceneManager.resetCamera(this.cityRenderer.getSpiralRadius());
+                    if (this._sourceCode) {
+                        this._buildCodePanel(this._sourceCode);
+                    }
+                }
+            }
+            this._updateStats(this.worldState.trace.length);
+
+            start += slice.traces.length;
+            this._setProgress(total ? start / total : 1);
+        }
+        this._setProgress(null);
+    }
+
+    /**
+     * Clear every renderer and panel before loading a new trace.
+     */
+    _clearForNewTrace() {
+        // Clear previous city and code panel
+        this.cityRenderer.clear();
+        this._removeCodePanel();
+
+        // Clear any existing error notification
+        const errorPanel = document.getElementById('errorNotification');
+        if (errorPanel) {
+            errorPanel.remove();
+        }
+
+        // Clear any active galaxy warp
+        if (this.galaxyWarpManager) {
+            this.galaxyWarpManager.clear();
+        }
+
+        // Clear causality web
+        if (this.causalityRenderer) {
+            this.causalityRenderer.clear();
+        }
+
+        // Clear panoramic render
+        if (this.panoramicRenderer) {
+            this.panoramicRenderer.clear();
+        }
+
+        // Clear sequencer
+        if (this.sequencerRenderer) {
+            this.sequencerRenderer.clear();
+        }
+
+        // Clear memory pool
+        if (this.memoryPoolRenderer) {
+            this.memoryPoolRenderer.clear();
+        }
     }
 
     // ─── Camera ────────────────────────────────────────────────────
@@ -607,12 +882,11 @@ class CodeVisualizer {
         const saveBtn = document.querySelector('.code-save-btn');
         if (saveBtn) { saveBtn.disabled = true; saveBtn.textContent = 'Processing...'; }
 
-        // Upload to process endpoint (doesn't save to disk)
-        const formData = new FormData();
-        formData.append('file', file);
-        
-        fetch('/api/process-file', { method: 'POST', body: formData })
-            .then(res => res.json())
+        // Enqueue as an async job — the button text tracks the
+        // pipeline stage while it runs
+        processFileJob(file, (label) => {
+            if (saveBtn) saveBtn.textContent = label;
+        })
             .then(json => {
                 // Always visualize, even if there are errors
                 // The visualizer will show error indicators for compile/runtime errors
@@ -621,7 +895,15 @@ class CodeVisualizer {
                 //     alert(`Error (${err.stage || 'unknown'}): ${err.message || 'Unknown error'}`);
                 //     return;
                 // }
-                this.visualize(json);
+                // Differential update: unchanged buildings survive the
+                // re-run. When the server stored the trace, pull it
+                // window by window instead of shipping the records in
+                // the job result.
+                if (json.trace_id) {
+                    this.visualizeWindowedUpdate(json.trace_id);
+                } else {
+                    this.visualizeUpdate(json);
+                }
                 
                 // Update the file in the code files list
                 const codeFileList = document.getElementById('codeFileList');
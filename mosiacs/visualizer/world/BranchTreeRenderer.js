@@ -206,16 +206,33 @@ class BranchTreeRenderer {
             return this._fallbackStructure(branchEntity);
         }
 
-        // Gather all CONDITION and BRANCH events vs regular child steps
+        // Gather all CONDITION and BRANCH events vs regular child steps.
+        // When the trace carries precomputed scope ids (see CallTreeIndex
+        // in normalize.py), only events sitting directly in this branch's
+        // scope — or closing the chain member currently open — count as
+        // chain structure. An elif condition only ever follows a FALSE
+        // one, so a condition in a taken arm is a nested if and stays an
+        // ordinary child step instead of becoming a fake elif link.
+        const nodeId = (branchEntity && typeof branchEntity.nodeId === 'number')
+            ? branchEntity.nodeId : null;
         const conditions = [];
         let currentCondition = null;
         const childSteps = [];
+        let lastChainResult = branchEntity ? !!branchEntity.result : false;
 
         for (const idx of childIndices) {
             const step = trace[idx];
             if (!step) continue;
 
-            if (step.type === 'CONDITION') {
+            let inChain = nodeId === null || step.scope == null;
+            if (!inChain) {
+                inChain = step.type === 'CONDITION'
+                    ? (!lastChainResult && step.scope === nodeId)
+                    : (step.scope === nodeId
+                        || (currentCondition !== null && step.scope === currentCondition.nodeId));
+            }
+
+            if (step.type === 'CONDITION' && inChain) {
                 // New condition in an elif chain
                 if (currentCondition) {
                     conditions.push(currentCondition);
@@ -225,9 +242,11 @@ class BranchTreeRenderer {
                     conditionResult: !!(step.conditionResult ?? step.condition_result),
                     branchSubtype: null,
                     isTaken: false,
+                    nodeId: typeof step.node === 'number' ? step.node : null,
                     childIndices: []
                 };
-            } else if (step.type === 'BRANCH') {
+                lastChainResult = currentCondition.conditionResult;
+            } else if (step.type === 'BRANCH' && inChain) {
                 // Marks which branch was taken
                 if (currentCondition) {
                     currentCondition.branchSubtype = step.subtype || step.name || 'if';
@@ -239,6 +258,7 @@ class BranchTreeRenderer {
                         conditionResult: true,
                         branchSubtype: step.subtype || 'else',
                         isTaken: true,
+                        nodeId: null,
                         childIndices: []
                     };
                 }
@@ -0,0 +1,94 @@
+/**
+ * BubbleAnimator — baked keyframe animations for flow bubbles.
+ *
+ * Flow bubbles used to run one requestAnimationFrame callback each,
+ * mutating position, scaling and material alpha from JavaScript every
+ * frame. Opening a large district could leave dozens of these loops
+ * competing with the render loop on the main thread.
+ *
+ * Instead, the path traversal and the pulse/shimmer sines are baked
+ * into Babylon Animation keyframes once, and the scene's animation
+ * engine evaluates them natively — per frame the cost is interpolation
+ * inside Babylon, not a JS closure per bubble. Bubbles are staggered
+ * along the loop by starting the animatable at a phase offset.
+ */
+class BubbleAnimator {
+    /**
+     * Start a looping bubble animation.
+     *
+     * @param {BABYLON.Scene} scene
+     * @param {BABYLON.Mesh} bubble   – target (own material expected)
+     * @param {BABYLON.Vector3[]} pathPoints – polyline to travel
+     * @param {Object} opts
+     * @param {number} opts.duration  – ms for one full path loop
+     * @param {number} [opts.stagger] – 0..1 phase offset along the loop
+     * @param {Object} [opts.pulse]   – { amp, period, phase } scaling sine
+     * @param {Object} [opts.shimmer] – { base, amp, period, phase } alpha sine
+     * @returns {BABYLON.Animatable} – stop() is the cancel handle
+     */
+    static animate(scene, bubble, pathPoints, opts) {
+        const fps = 30;
+        const totalFrames = Math.max(2, Math.round((opts.duration / 1000) * fps));
+
+        // One key per path point, evenly spaced — matches the old
+        // constant-speed segment interpolation.
+        const pos = new BABYLON.Animation(
+            'bubblePath', 'position', fps,
+            BABYLON.Animation.ANIMATIONTYPE_VECTOR3,
+            BABYLON.Animation.ANIMATIONLOOPMODE_CYCLE
+        );
+        const last = Math.max(pathPoints.length - 1, 1);
+        pos.setKeys(pathPoints.map((p, i) => ({
+            frame: (i / last) * totalFrames,
+            value: p.clone()
+        })));
+
+        const animations = [pos];
+        if (opts.pulse) {
+            animations.push(BubbleAnimator._sine(
+                'bubblePulse', 'scaling', fps, totalFrames, opts.duration,
+                { base: 1, vector: true, ...opts.pulse }
+            ));
+        }
+        if (opts.shimmer && bubble.material) {
+            animations.push(BubbleAnimator._sine(
+                'bubbleShimmer', 'material.alpha', fps, totalFrames, opts.duration,
+                { vector: false, ...opts.shimmer }
+            ));
+        }
+
+        const animatable = scene.beginDirectAnimation(
+            bubble, animations, 0, totalFrames, true
+        );
+        if (opts.stagger) {
+            animatable.goToFrame((opts.stagger % 1) * totalFrames);
+        }
+        return animatable;
+    }
+
+    /**
+     * Bake a sine wave into keyframes. The cycle count is rounded to a
+     * whole number so the loop seam stays continuous.
+     */
+    static _sine(name, property, fps, totalFrames, duration,
+                 { base, amp, period, phase = 0, vector }) {
+        const cycles = Math.max(1, Math.round(duration / period));
+        const samples = cycles * 8;   // 8 keys per cycle reads as smooth
+        const anim = new BABYLON.Animation(
+            name, property, fps,
+            vector ? BABYLON.Animation.ANIMATIONTYPE_VECTOR3
+                   : BABYLON.Animation.ANIMATIONTYPE_FLOAT,
+            BABYLON.Animation.ANIMATIONLOOPMODE_CYCLE
+        );
+        const keys = [];
+        for (let i = 0; i <= samples; i++) {
+            const v = base + Math.sin((i / samples) * cycles * 2 * Math.PI + phase) * amp;
+            keys.push({
+                frame: (i / samples) * totalFrames,
+                value: vector ? new BABYLON.Vector3(v, v, v) : v
+            });
+        }
+        anim.setKeys(keys);
+        return anim;
+    }
+}
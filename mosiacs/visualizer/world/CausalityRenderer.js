@@ -39,6 +39,15 @@ class CausalityRenderer {
 
     // ─── Public API ────────────────────────────────────────────────
 
+    /**
+     * Provide the server-side causality index (the `causality` JSON
+     * section from normalize.py). When set, the web draws these
+     * precomputed edges instead of rescanning the trace in the browser.
+     */
+    setPrecomputed(causality) {
+        this._precomputed = causality || null;
+    }
+
     isVisible() {
         return this._visible;
     }
@@ -110,6 +119,12 @@ class CausalityRenderer {
      * Returns an array of { fromKey, toKey, strength, readValue }
      */
     _computeCausalLinks(snapshot, trace) {
+        // Precomputed server-side index wins — no trace scan at all
+        if (this._precomputed && Array.isArray(this._precomputed.links)) {
+            const links = this._computeLinksFromIndex(snapshot);
+            if (links.length > 0) return links;
+        }
+
         const readRelations = snapshot.readRelations || [];
 
         if (readRelations.length > 0) {
@@ -120,6 +135,38 @@ class CausalityRenderer {
         return this._computeLinksHeuristic(snapshot, trace);
     }
 
+    /**
+     * Map the precomputed index's variable entries (name + address) onto
+     * the snapshot's variable-house keys and emit drawable links.
+     */
+    _computeLinksFromIndex(snapshot) {
+        const { variables, links } = this._precomputed;
+
+        const varKeyMap = new Map();
+        for (const v of snapshot.variables) {
+            varKeyMap.set(`${v.name}|${v.address}`, v.key);
+        }
+
+        const result = [];
+        const seen = new Set();
+        for (const link of links) {
+            const from = variables[link.from];
+            const to = variables[link.to];
+            if (!from || !to) continue;
+
+            const fromKey = varKeyMap.get(`${from.name}|${from.address}`);
+            const toKey = varKeyMap.get(`${to.name}|${to.address}`);
+            if (!fromKey || !toKey || fromKey === toKey) continue;
+
+            const linkId = `${fromKey}->${toKey}`;
+            if (seen.has(linkId)) continue;
+            seen.add(linkId);
+
+            result.push({ fromKey, toKey, strength: 0.8 });
+        }
+        return result;
+    }
+
     /**
      * Build links directly from READ relations (precise data-flow).
      */
@@ -56,7 +56,9 @@ class CityRenderer {
         this.spiralAngleStep = SPIRAL_CONFIG.angleStep;
         this.spiralHeightStep = SPIRAL_CONFIG.heightStep;
 
-        // Slot management
+        // Slot management — each entity takes a stride of slots so
+        // neighbouring buildings get breathing room on the spiral
+        this._slotStride = 4;
         this._nextSlot = 0;
         this._slotMap = new Map();
 
@@ -66,11 +68,41 @@ class CityRenderer {
         // Hover
         this._hoveredLabel = null;
         this._hoverAttached = false;
+        this._pickGrid = new PickGrid(scene);
 
         // ── Sub-spiral push-out tracking ──
         // Maps parentKey → { boundingRadius, parentPos, parentSlot }
         this._openSubSpirals = new Map();
 
+        // ── Thin-instance mode (large traces) ──
+        // Above this many entities the per-building path (two meshes, a
+        // label and two materials each) drowns the scene in draw calls,
+        // so buildings collapse into one thin-instanced master mesh per
+        // archetype with per-instance matrices and colours.
+        this.instancedThreshold = 3000;
+        this._instancedMode = false;
+        this._archetypeMasters = null;
+        this._instanceEntities = new Map();   // archetype → [entity, …]
+        this._instanceHoverLabel = null;      // shared label, retargeted on hover
+
+        // ── Level of detail ──
+        // Beyond midDistance a building drops its secondary geometry
+        // (caps, roofs, chimneys, branch paths) and pauses animations;
+        // beyond farDistance it collapses into a thin-instanced impostor
+        // cloud. Detail streams back in as the camera approaches.
+        this.lodMidDistance = 90;
+        this.lodFarDistance = 180;
+        this.lodUpdateInterval = 250;    // ms between LOD passes
+        this._lodAttached = false;
+        this._lodImpostorMaster = null;
+
+        // ── Precomputed layout (LayoutWorker) ──
+        // xyz per slot, valid only while the slot count it was built for
+        // matches the live spiral; stale tables fall through to the
+        // on-the-fly computation.
+        this._positionTable = null;
+        this._positionTableCount = 0;
+
         // ── Main spiral flow bubbles ──
         this._mainBubbles = [];           // active bubble meshes
         this._mainBubbleRAFs = [];        // RAF IDs for cancellation
@@ -98,10 +130,12 @@ class CityRenderer {
             if (now - lastHoverTime < hoverInterval) return;
             lastHoverTime = now;
 
-            // Check for main buildings, sub-spiral dots, galaxy buildings, and bubble nodes
-            const pick = this.scene.pick(
+            // Check for main buildings, sub-spiral dots, galaxy buildings, and
+            // bubble nodes. The grid resolves the ray against bounding volumes
+            // in the cells it crosses instead of scanning every scene mesh.
+            const pick = this._pickGrid.pick(
                 this.scene.pointerX, this.scene.pointerY,
-                (m) => m._buildingData != null || m._subSpiralDot != null || m._isGalaxyBuilding != null || m._isBubbleNode != null
+                (m) => m._buildingData != null || m._subSpiralDot != null || m._isGalaxyBuilding != null || m._isBubbleNode != null || m._isArchetypeMaster != null
             );
 
             if (pick && pick.hit && pick.pickedMesh) {
@@ -115,6 +149,11 @@ class CityRenderer {
                         this._hoveredLabel = entry.label;
                     }
                 }
+                // Handle thin-instance hover — resolve the instance index
+                // back to its entity and retarget the shared label
+                else if (pick.pickedMesh._isArchetypeMaster && pick.thinInstanceIndex >= 0) {
+                    this._showInstanceLabel(pick.pickedMesh._isArchetypeMaster, pick.thinInstanceIndex);
+                }
                 // Handle sub-spiral dot hover
                 else if (pick.pickedMesh._subSpiralDot && pick.pickedMesh._label) {
                     if (this._hoveredLabel && this._hoveredLabel !== pick.pickedMesh._label)
@@ -143,6 +182,8 @@ class CityRenderer {
         });
     }
 
+    // Per-mesh lookup for the classic path; thin-instance picks resolve
+    // through _entityForInstance (archetype + instance index) instead.
     _entryForMesh(mesh) {
         for (const cache of [this.functionMeshes, this.variableMeshes, this.loopMeshes, this.whileMeshes, this.branchMeshes]) {
             for (const [, entry] of cache) {
@@ -152,12 +193,69 @@ class CityRenderer {
         return null;
     }
 
+    _entityForInstance(archetype, index) {
+        const list = this._instanceEntities.get(archetype);
+        return list ? list[index] : undefined;
+    }
+
+    _showInstanceLabel(archetype, index) {
+        const ent = this._entityForInstance(archetype, index);
+        if (!ent) return;
+
+        const d = this._instanceDescriptor(archetype, ent);
+        const pos = this._spiralPositionBase(this._slotFor(ent.key));
+        const text = this._instanceLabelText(archetype, ent);
+
+        if (!this._instanceHoverLabel) {
+            this._instanceHoverLabel = this.labelHelper.create(
+                'instanceHoverLabel', text, pos, d.height + 1, d.color
+            );
+        } else {
+            this._instanceHoverLabel.position = pos.clone();
+            this._instanceHoverLabel.position.y += d.height + 1;
+            this._instanceHoverLabel._labelColor = d.color;
+            this.labelHelper.update(this._instanceHoverLabel, text);
+        }
+
+        if (this._hoveredLabel && this._hoveredLabel !== this._instanceHoverLabel)
+            this._hoveredLabel.isVisible = false;
+        this._instanceHoverLabel.isVisible = true;
+        this._hoveredLabel = this._instanceHoverLabel;
+    }
+
+    _instanceLabelText(archetype, ent) {
+        switch (archetype) {
+            case 'function': return ent.name || ent.key;
+            case 'variable': return `${ent.name} = ${ent.currentValue}`;
+            case 'loop':
+            case 'while':    return `${(ent.subtype || 'loop').toUpperCase()} (${ent.condition}) ×${ent.iterations}`;
+            case 'branch':   return `IF (${ent.condition}) → ${ent.result ? 'true' : 'false'}`;
+            case 'console':  return ent.message || 'Output';
+            default:         return ent.key;
+        }
+    }
+
     // ─── Spiral geometry ───────────────────────────────────────────
 
     /**
      * Base spiral position (no push-out applied).
      */
+    /**
+     * Install a worker-computed position table (xyz per slot). Only used
+     * while the spiral still has exactly `count` slots — Y depends on the
+     * total, so a grown spiral invalidates the table naturally.
+     */
+    setPositionTable(positions, count) {
+        this._positionTable = positions;
+        this._positionTableCount = count;
+    }
+
     _spiralPositionBase(slot) {
+        const t = this._positionTable;
+        if (t && slot < this._positionTableCount &&
+            this._positionTableCount === Math.max(this._nextSlot, 1)) {
+            return new BABYLON.Vector3(t[slot * 3], t[slot * 3 + 1], t[slot * 3 + 2]);
+        }
         const angle = getSpiralAngle(slot);
         const radius = this.spiralRadiusStart + slot * this.spiralRadiusGrowth;
         const y = getSpiralY(slot, Math.max(this._nextSlot, 1));
@@ -215,11 +313,25 @@ class CityRenderer {
     _slotFor(key) {
         if (!this._slotMap.has(key)) {
             this._slotMap.set(key, this._nextSlot);
-            this._nextSlot += 4;
+            this._nextSlot += this._slotStride;
         }
         return this._slotMap.get(key);
     }
 
+    /**
+     * What `_nextSlot` will be once every key in `keys` has a slot —
+     * already-assigned keys keep theirs, new ones advance by the
+     * stride. Lets the layout table be sized for the spiral that
+     * render() is about to produce (Y depends on the total).
+     */
+    slotCountAfter(keys) {
+        let next = this._nextSlot;
+        for (const key of keys) {
+            if (!this._slotMap.has(key)) next += this._slotStride;
+        }
+        return next;
+    }
+
     _spiralTangentAngle(slot) {
         const angle = getSpiralAngle(slot);
         const radius = this.spiralRadiusStart + slot * this.spiralRadiusGrowth;
@@ -235,6 +347,7 @@ class CityRenderer {
 
     render(snapshot) {
         this._ensureHoverObserver();
+        this._ensureLODObserver();
 
         // Keep references for on-demand sub-spiral rendering and re-rendering
         this._lastTrace = snapshot.trace || [];
@@ -250,6 +363,17 @@ class CityRenderer {
             }
         }
 
+        // Large traces: collapse buildings into thin-instanced archetype
+        // masters — one draw call per archetype instead of per building.
+        const entityCount = snapshot.creationOrder ? snapshot.creationOrder.length : 0;
+        const useInstanced = entityCount >= this.instancedThreshold;
+        if (useInstanced !== this._instancedMode) this._switchRenderMode(useInstanced);
+        if (useInstanced) {
+            this._renderInstanced(snapshot);
+            this._renderSpiralPath();
+            return;
+        }
+
         this._renderFunctions(snapshot.functions, snapshot.callStack);
         this._renderVariables(snapshot.variables);
         this._renderLoops(snapshot.loops);
@@ -267,6 +391,268 @@ class CityRenderer {
         this._freezeStaticMeshes();
     }
 
+    // ─── Level of detail ───────────────────────────────────────────
+
+    _ensureLODObserver() {
+        if (this._lodAttached) return;
+        this._lodAttached = true;
+
+        // Throttled like the hover observer — a full distance pass every
+        // frame would cost more than the detail it saves.
+        let lastLodTime = 0;
+        this.scene.onBeforeRenderObservable.add(() => {
+            const now = Date.now();
+            if (now - lastLodTime < this.lodUpdateInterval) return;
+            lastLodTime = now;
+            this._updateLOD();
+        });
+    }
+
+    _updateLOD() {
+        // The thin-instance path is already one draw call per archetype
+        if (this._instancedMode) return;
+
+        const camera = this.scene.activeCamera;
+        if (!camera) return;
+        const camPos = camera.globalPosition || camera.position;
+
+        let farChanged = false;
+        const farEntries = [];
+
+        const caches = [this.functionMeshes, this.variableMeshes,
+                        this.loopMeshes, this.whileMeshes, this.branchMeshes];
+        for (const cache of caches) {
+            for (const [, entry] of cache) {
+                if (!entry.mesh || entry.mesh.isDisposed()) continue;
+
+                const dist = BABYLON.Vector3.Distance(camPos, entry.mesh.position);
+                const tier = dist > this.lodFarDistance ? 2
+                           : dist > this.lodMidDistance ? 1 : 0;
+
+                if (entry._lodTier !== tier) {
+                    if (entry._lodTier === 2 || tier === 2) farChanged = true;
+                    this._applyLodTier(entry, tier);
+                    entry._lodTier = tier;
+                }
+                if (tier === 2) farEntries.push(entry);
+            }
+        }
+
+        if (farChanged) this._rebuildLodImpostors(farEntries);
+    }
+
+    _lodSecondaryMeshes(entry) {
+        return [entry.cap, entry.roof, entry.chimney, entry.truePath, entry.falsePath]
+            .filter(m => m && !m.isDisposed());
+    }
+
+    _applyLodTier(entry, tier) {
+        const secondaries = this._lodSecondaryMeshes(entry);
+
+        if (tier === 2) {
+            // Far: the impostor cloud stands in for the whole building
+            entry.mesh.setEnabled(false);
+            secondaries.forEach(s => s.setEnabled(false));
+            if (entry.label) entry.label.isVisible = false;
+            if (entry.errorIndicator && !entry.errorIndicator.isDisposed()) {
+                this.scene.stopAnimation(entry.errorIndicator);
+                entry.errorIndicator.setEnabled(false);
+            }
+        } else if (tier === 1) {
+            // Mid: main silhouette only, animations paused
+            entry.mesh.setEnabled(true);
+            this.scene.stopAnimation(entry.mesh);
+            entry.mesh.scaling.setAll(1);    // settle any in-flight scale-in
+            secondaries.forEach(s => s.setEnabled(false));
+            if (entry.errorIndicator && !entry.errorIndicator.isDisposed()) {
+                this.scene.stopAnimation(entry.errorIndicator);
+                entry.errorIndicator.setEnabled(false);
+            }
+        } else {
+            // Near: full detail, pulse resumes on error indicators
+            entry.mesh.setEnabled(true);
+            entry.mesh.scaling.setAll(1);
+            secondaries.forEach(s => { s.setEnabled(true); s.scaling.setAll(1); });
+            if (entry.errorIndicator && !entry.errorIndicator.isDisposed()) {
+                entry.errorIndicator.setEnabled(true);
+                this._pulseAnimation(entry.errorIndicator);
+            }
+        }
+    }
+
+    _ensureLodImpostorMaster() {
+        if (this._lodImpostorMaster) return this._lodImpostorMaster;
+
+        const master = BABYLON.MeshBuilder.CreateBox('master_lodImpostor', {
+            height: 1, width: 1, depth: 1
+        }, this.scene);
+        master.bakeTransformIntoVertices(BABYLON.Matrix.Translation(0, 0.5, 0));
+
+        const mat = new BABYLON.StandardMaterial('lodImpostorMat', this.scene);
+        mat.diffuseColor = new BABYLON.Color3(1, 1, 1);
+        mat.emissiveColor = new BABYLON.Color3(0.3, 0.3, 0.3);
+        mat.specularColor = BABYLON.Color3.Black();
+        master.material = mat;
+
+        master.isPickable = false;       // far buildings don't hover
+        master.isVisible = false;
+        this._lodImpostorMaster = master;
+        return master;
+    }
+
+    /**
+     * Rebuild the impostor cloud for all far-tier buildings: one
+     * thin-instanced box per building, scaled to its silhouette.
+     */
+    _rebuildLodImpostors(farEntries) {
+        const master = this._ensureLodImpostorMaster();
+        const n = farEntries.length;
+        master.isVisible = n > 0;
+        if (n === 0) return;
+
+        const widthByType = { function: 3.5, variable: 1.4, loop: 2.6, while: 2.6, branch: 2.2 };
+        const matrices = new Float32Array(n * 16);
+        const colors = new Float32Array(n * 4);
+        const scratch = BABYLON.Matrix.Identity();
+
+        for (let i = 0; i < n; i++) {
+            const entry = farEntries[i];
+            const width = widthByType[entry.type] || 2;
+            const pos = entry.mesh.position;
+            // Function and branch meshes carry their height baked in
+            // (position = base); box-centred types are offset by height/2.
+            const baseY = (entry.type === 'function' || entry.type === 'branch')
+                ? pos.y : pos.y - entry.height / 2;
+
+            BABYLON.Matrix.ScalingToRef(width, entry.height, width, scratch);
+            scratch.setTranslationFromFloats(pos.x, baseY, pos.z);
+            scratch.copyToArray(matrices, i * 16);
+
+            const c = entry.color || { r: 0.5, g: 0.5, b: 0.5 };
+            colors[i * 4]     = c.r;
+            colors[i * 4 + 1] = c.g;
+            colors[i * 4 + 2] = c.b;
+            colors[i * 4 + 3] = 1;
+        }
+
+        master.thinInstanceSetBuffer('matrix', matrices, 16);
+        master.thinInstanceSetBuffer('color', colors, 4);
+    }
+
+    // ─── Thin-instance rendering (large traces) ────────────────────
+
+    /**
+     * Switch between the per-mesh path and the thin-instance path,
+     * disposing whichever representation is being left behind. Slot
+     * assignments survive the switch so positions stay stable.
+     */
+    _switchRenderMode(instanced) {
+        this._instancedMode = instanced;
+        if (instanced) {
+            [this.functionMeshes, this.variableMeshes, this.loopMeshes,
+             this.whileMeshes, this.branchMeshes, this.blackHoleMeshes,
+             this.consoleBubbles].forEach(cache => {
+                cache.forEach(entry => this._disposeEntry(entry));
+                cache.clear();
+            });
+            this.memoryLines.forEach(l => l.dispose());
+            this.memoryLines = [];
+            this.blackHoleConnections.forEach(c => c.dispose());
+            this.blackHoleConnections = [];
+            if (this._lodImpostorMaster) this._lodImpostorMaster.isVisible = false;
+        } else if (this._archetypeMasters) {
+            Object.values(this._archetypeMasters).forEach(m => m.dispose());
+            this._archetypeMasters = null;
+            this._instanceEntities.clear();
+        }
+    }
+
+    /**
+     * Rebuild the per-instance matrix and colour buffers from the
+     * snapshot. Whole-buffer rebuilds are cheap (two typed arrays per
+     * archetype) next to creating even a handful of real meshes.
+     */
+    _renderInstanced(snapshot) {
+        if (!this._archetypeMasters)
+            this._archetypeMasters = this.meshFactory.createArchetypeMasters();
+
+        const groups = {
+            function: snapshot.functions || [],
+            variable: snapshot.variables || [],
+            loop:     snapshot.loops || [],
+            while:    snapshot.whileLoops || [],
+            branch:   snapshot.branches || [],
+            console:  snapshot.consoleOutputs || []
+        };
+
+        for (const [archetype, entities] of Object.entries(groups)) {
+            const master = this._archetypeMasters[archetype];
+            const n = entities.length;
+            master.isVisible = n > 0;
+            this._instanceEntities.set(archetype, entities);
+            if (n === 0) continue;
+
+            const matrices = new Float32Array(n * 16);
+            const colors = new Float32Array(n * 4);
+            const scratch = BABYLON.Matrix.Identity();
+
+            for (let i = 0; i < n; i++) {
+                const ent = entities[i];
+                const d = this._instanceDescriptor(archetype, ent);
+                const pos = this._spiralPositionBase(this._slotFor(ent.key));
+
+                BABYLON.Matrix.ScalingToRef(d.width, d.height, d.width, scratch);
+                scratch.setTranslationFromFloats(pos.x, pos.y, pos.z);
+                scratch.copyToArray(matrices, i * 16);
+
+                colors[i * 4]     = d.color.r;
+                colors[i * 4 + 1] = d.color.g;
+                colors[i * 4 + 2] = d.color.b;
+                colors[i * 4 + 3] = 1;
+            }
+
+            master.thinInstanceSetBuffer('matrix', matrices, 16);
+            master.thinInstanceSetBuffer('color', colors, 4);
+        }
+    }
+
+    /**
+     * Size and colour for one instance — mirrors the dimensions and
+     * palette the MeshFactory builders use, dimmed when inactive.
+     */
+    _instanceDescriptor(archetype, ent) {
+        let height, width, color;
+        switch (archetype) {
+            case 'function':
+                height = 4 + (ent.depth || 0) * 2.5;
+                width = 3.5;
+                color = ent.isExternal
+                    ? { r: 0.3, g: 0.1, b: 0.45 }
+                    : { r: 0.8, g: 0.2, b: 0.2 };
+                break;
+            case 'variable':
+                height = 2; width = 1.4;
+                color = { r: 0.2, g: 0.4, b: 0.8 };
+                break;
+            case 'loop':
+            case 'while':
+                height = 3; width = 2.6;
+                color = { r: 0.6, g: 0.2, b: 0.8 };
+                break;
+            case 'branch':
+                height = 2.2; width = 2.2;
+                color = { r: 0.9, g: 0.4, b: 0.2 };
+                break;
+            default:  // console
+                height = 1; width = 1;
+                color = { r: 0.9, g: 0.9, b: 0.3 };
+        }
+        if (ent.active === false) {
+            color = { r: color.r * 0.45, g: color.g * 0.45, b: color.b * 0.45 };
+        }
+        return { height, width, color };
+    }
+
     // ─── Error checking ────────────────────────────────────────────
 
     /**
@@ -515,6 +901,22 @@ class CityRenderer {
         this.blackHoleConnections = [];
         if (this._spiralTube) { this._spiralTube.dispose(); this._spiralTube = null; }
         if (this._spiralTubeError) { this._spiralTubeError.dispose(); this._spiralTubeError = null; }
+        if (this._archetypeMasters) {
+            Object.values(this._archetypeMasters).forEach(m => m.dispose());
+            this._archetypeMasters = null;
+        }
+        if (this._instanceHoverLabel) {
+            this._instanceHoverLabel.dispose();
+            this._instanceHoverLabel = null;
+        }
+        if (this._lodImpostorMaster) {
+            this._lodImpostorMaster.dispose();
+            this._lodImpostorMaster = null;
+        }
+        this._instanceEntities.clear();
+        this._instancedMode = false;
+        this._positionTable = null;
+        this._positionTableCount = 0;
         this._nextSlot = 0;
         this._slotMap.clear();
         this._openSubSpirals.clear();
@@ -525,6 +927,35 @@ class CityRenderer {
         this._disposeMainBubbles();
     }
 
+    /**
+     * Dispose cached entities whose key is not in the active set.
+     *
+     * render() is idempotent per entity key — re-rendering a new
+     * snapshot reuses every building whose key survived — but it never
+     * removes keys that vanished. Watch-mode updates call this after
+     * render() so an edited program sheds only the buildings past the
+     * point where its trace diverged, instead of a full clear().
+     * Assigned spiral slots are kept: surviving buildings stay put.
+     */
+    pruneStale(activeKeys) {
+        [this.functionMeshes, this.variableMeshes, this.loopMeshes,
+        this.whileMeshes, this.branchMeshes, this.blackHoleMeshes, this.consoleBubbles].forEach(cache => {
+            for (const [key, entry] of cache) {
+                if (!activeKeys.has(key)) {
+                    if (this._openSubSpirals.has(key)) {
+                        // Whichever renderer opened it, closing is a no-op
+                        // for the other two
+                        this.subSpiralRenderer.removeSingle(key);
+                        this.loopBubbleRenderer.removeBubble(key);
+                        this.branchTreeRenderer.removeTree(key);
+                    }
+                    this._disposeEntry(entry);
+                    cache.delete(key);
+                }
+            }
+        });
+    }
+
     /**
      * Return the outer radius of the spiral based on the number of slots used.
      * Useful for dynamically positioning the camera.
@@ -684,50 +1115,18 @@ class CityRenderer {
 
     /**
      * Animate a single bubble flowing along the main spiral path.
+     * Keyframes are baked once (BubbleAnimator) and evaluated by the
+     * scene's animation engine — no per-frame JS per bubble.
      */
     _animateMainBubble(bubble, pathPoints, index, totalBubbles) {
         const duration = this.mainBubbleDuration + Math.random() * this.mainBubbleDurationVariance;
-        const staggerDelay = (index / totalBubbles) * duration;
-
-        let startTime = null;
-        let rafId = null;
-
-        const animate = (time) => {
-            if (bubble.isDisposed()) return;
-
-            if (!startTime) startTime = time - staggerDelay;
-
-            const elapsed = time - startTime;
-            const loopTime = elapsed % duration;
-            const t = loopTime / duration;  // 0 → 1 along path (top to bottom)
-
-            // Interpolate position along the path
-            const pathProgress = t * (pathPoints.length - 1);
-            const segmentIndex = Math.floor(pathProgress);
-            const segmentFrac = pathProgress - segmentIndex;
-
-            if (segmentIndex < pathPoints.length - 1) {
-                const p0 = pathPoints[segmentIndex];
-                const p1 = pathPoints[segmentIndex + 1];
-                bubble.position = BABYLON.Vector3.Lerp(p0, p1, segmentFrac);
-            } else {
-                bubble.position = pathPoints[pathPoints.length - 1].clone();
-            }
-
-            // Gentle pulsing scale for organic "floating" feel
-            const pulse = 1 + Math.sin(time * 0.004 + index * 2) * 0.3;
-            bubble.scaling.setAll(pulse);
-
-            // Slight alpha variation for shimmer effect
-            if (bubble.material) {
-                bubble.material.alpha = 0.6 + Math.sin(time * 0.003 + index * 0.8) * 0.2;
-            }
-
-            rafId = requestAnimationFrame(animate);
-        };
-
-        rafId = requestAnimationFrame(animate);
-        this._mainBubbleRAFs.push(() => cancelAnimationFrame(rafId));
+        const animatable = BubbleAnimator.animate(this.scene, bubble, pathPoints, {
+            duration,
+            stagger: index / totalBubbles,
+            pulse: { amp: 0.3, period: 1570, phase: index * 2 },
+            shimmer: { base: 0.6, amp: 0.2, period: 2090, phase: index * 0.8 }
+        });
+        this._mainBubbleRAFs.push(() => animatable.stop());
     }
 
     /**
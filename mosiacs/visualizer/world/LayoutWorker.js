@@ -0,0 +1,63 @@
+/**
+ * LayoutWorker — background thread for trace parsing and spiral layout.
+ *
+ * Big traces used to freeze the page for seconds: CodeParser mapped the
+ * whole record array on the main thread, and every building's spiral
+ * position was computed during render. This worker takes both off the
+ * UI thread:
+ *
+ *   { type: 'parse',  id, data }   → { type: 'parsed', id, steps,
+ *                                      metadata, error, causality }
+ *   { type: 'layout', id, count }  → { type: 'layout', id, count,
+ *                                      positions }  (transferable
+ *                                      Float32Array, xyz per slot)
+ *
+ * Layout jobs post { type: 'progress', id, done, total } along the way
+ * so the loading bar moves while the table is being filled. The client
+ * (CodeVisualizer) treats the worker as a pure accelerator and falls
+ * back to synchronous parsing/layout whenever it is unavailable.
+ */
+importScripts('../../parser.js', '../SpiralConfig.js');
+
+const PROGRESS_EVERY = 10000;
+
+self.onmessage = (e) => {
+    const msg = e.data || {};
+
+    if (msg.type === 'parse') {
+        const parser = new CodeParser();
+        const steps = parser.parse(msg.data);
+        self.postMessage({
+            type: 'parsed',
+            id: msg.id,
+            steps,
+            metadata: parser.metadata,
+            error: parser.error,
+            causality: parser.causality
+        });
+        return;
+    }
+
+    if (msg.type === 'layout') {
+        const count = Math.max(msg.count | 0, 1);
+        const positions = new Float32Array(count * 3);
+        const { radiusStart, radiusGrowth } = SPIRAL_CONFIG;
+
+        for (let slot = 0; slot < count; slot++) {
+            const angle = getSpiralAngle(slot);
+            const radius = radiusStart + slot * radiusGrowth;
+            positions[slot * 3]     = Math.cos(angle) * radius;
+            positions[slot * 3 + 1] = getSpiralY(slot, count);
+            positions[slot * 3 + 2] = Math.sin(angle) * radius;
+
+            if (slot > 0 && slot % PROGRESS_EVERY === 0) {
+                self.postMessage({ type: 'progress', id: msg.id, done: slot, total: count });
+            }
+        }
+
+        self.postMessage(
+            { type: 'layout', id: msg.id, count, positions },
+            [positions.buffer]
+        );
+    }
+};
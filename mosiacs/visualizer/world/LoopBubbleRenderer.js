@@ -42,6 +42,16 @@ class LoopBubbleRenderer {
         // Rendering all of them as individual pickable meshes is expensive.
         this.maxBubbleNodes = 50;
 
+        // ── Iteration swarm ──
+        // Iteration counts used to surface only as a number in node
+        // labels. The swarm renders them as drifting motes inside the
+        // shell: one thin-instanced mesh per loop site (one draw call),
+        // iteration phase as a per-instance attribute, and the float/bob
+        // computed in the vertex shader from a single time uniform.
+        this.maxIterationInstances = 256;   // visual cap per bubble
+        this.iterationDotDiameter = 0.14;
+        this._swarmObserver = null;
+
         // Material cache for performance (shared across all bubbles)
         this._matCache = new Map();
 
@@ -109,6 +119,11 @@ class LoopBubbleRenderer {
         // Create entry connector from parent building to first node in bubble
         const entryConnector = this._createEntryConnector(parentPos, nodes[0], parentKey, bubbleColor);
 
+        // One thin-instanced mote swarm visualizes iteration density
+        const swarm = this._createIterationSwarm(
+            parentKey, parentPos, bubbleRadius, rawEntities, childIndices, bubbleColor
+        );
+
         // The bubble center is at parentPos (since bubble.position = parentPos)
         // This is where the camera should focus
         const bubbleCenter = parentPos.clone();
@@ -119,6 +134,7 @@ class LoopBubbleRenderer {
             nodes,
             connections,
             entryConnector,
+            swarm,
             boundingRadius: bubbleRadius,
             parentPos: parentPos.clone(),
             bubbleCenter: bubbleCenter,
@@ -162,6 +178,11 @@ class LoopBubbleRenderer {
             this._disposeBubble(bubbleData);
         }
         this.bubbles.clear();
+        // The swarm clock has nothing left to drive
+        if (this._swarmObserver) {
+            this.scene.onBeforeRenderObservable.remove(this._swarmObserver);
+            this._swarmObserver = null;
+        }
         // Dispose cached materials on full clear
         this._matCache.forEach(mat => {
             try { if (mat) mat.dispose(); } catch (e) { /* already disposed */ }
@@ -226,6 +247,128 @@ class LoopBubbleRenderer {
         return mat;
     }
 
+    // ─── Iteration Swarm ───────────────────────────────────────────
+
+    /**
+     * Register the swarm shaders once. The vertex shader rebuilds the
+     * thin-instance world matrix from its attribute rows and offsets the
+     * world position by a per-instance phased sine — so the whole swarm
+     * animates off one time uniform, no per-frame JS per mote.
+     */
+    _ensureSwarmShader() {
+        if (BABYLON.Effect.ShadersStore['iterSwarmVertexShader']) return;
+
+        BABYLON.Effect.ShadersStore['iterSwarmVertexShader'] = `
+            precision highp float;
+            attribute vec3 position;
+            attribute vec4 world0;
+            attribute vec4 world1;
+            attribute vec4 world2;
+            attribute vec4 world3;
+            attribute float phase;
+            uniform mat4 viewProjection;
+            uniform float time;
+            varying float vPhase;
+            void main() {
+                mat4 world = mat4(world0, world1, world2, world3);
+                vec4 wp = world * vec4(position, 1.0);
+                wp.y += sin(time * 2.0 + phase) * 0.2;
+                wp.x += cos(time * 1.3 + phase * 2.0) * 0.08;
+                gl_Position = viewProjection * wp;
+                vPhase = phase;
+            }`;
+
+        BABYLON.Effect.ShadersStore['iterSwarmFragmentShader'] = `
+            precision highp float;
+            uniform vec3 color;
+            uniform float time;
+            varying float vPhase;
+            void main() {
+                float glow = 0.45 + 0.25 * sin(time * 1.7 + vPhase * 3.0);
+                gl_FragColor = vec4(color * (0.6 + glow * 0.8), glow);
+            }`;
+    }
+
+    /**
+     * Build the iteration swarm for one loop site: a single low-poly
+     * sphere with one thin instance per (capped) iteration, laid out on
+     * a golden-angle spherical spiral inside the shell.
+     */
+    _createIterationSwarm(parentKey, centerPos, bubbleRadius, entities, childIndices, color) {
+        // Loop entities carry real iteration counts (sampled hot loops
+        // report their true total); the raw child step count is the
+        // fallback when the bubble holds no nested loops.
+        let total = 0;
+        for (const ent of entities) {
+            if (ent.type === 'loop') total += ent.iterations || 0;
+        }
+        total = Math.max(total, childIndices.length);
+        if (total < 2) return null;
+
+        const count = Math.min(total, this.maxIterationInstances);
+        this._ensureSwarmShader();
+
+        const swarm = BABYLON.MeshBuilder.CreateSphere(
+            `iterSwarm_${parentKey}`,
+            { diameter: this.iterationDotDiameter, segments: 4 },
+            this.scene
+        );
+        swarm.isPickable = false;
+
+        const matrices = new Float32Array(count * 16);
+        const phases = new Float32Array(count);
+        const golden = Math.PI * (3 - Math.sqrt(5));
+        const shellR = bubbleRadius * 0.8;
+        for (let i = 0; i < count; i++) {
+            const t = (i + 0.5) / count;
+            const y = 1 - 2 * t;
+            const ring = Math.sqrt(Math.max(0, 1 - y * y));
+            const azimuth = i * golden;
+            BABYLON.Matrix.Translation(
+                centerPos.x + Math.cos(azimuth) * ring * shellR,
+                centerPos.y + y * shellR,
+                centerPos.z + Math.sin(azimuth) * ring * shellR
+            ).copyToArray(matrices, i * 16);
+            phases[i] = (i / count) * Math.PI * 2;
+        }
+        swarm.thinInstanceSetBuffer('matrix', matrices, 16, true);
+        swarm.thinInstanceSetBuffer('phase', phases, 1, true);
+        swarm.thinInstanceRefreshBoundingInfo();
+
+        const mat = new BABYLON.ShaderMaterial(
+            `iterSwarmMat_${parentKey}`, this.scene,
+            { vertex: 'iterSwarm', fragment: 'iterSwarm' },
+            {
+                attributes: ['position', 'phase', 'world0', 'world1', 'world2', 'world3'],
+                uniforms: ['viewProjection', 'time', 'color'],
+                needAlphaBlending: true
+            }
+        );
+        mat.setColor3('color', new BABYLON.Color3(color.r, color.g, color.b));
+        mat.setFloat('time', 0);
+        mat.backFaceCulling = false;
+        swarm.material = mat;
+
+        this._ensureSwarmClock();
+        return swarm;
+    }
+
+    /**
+     * One observer advances the time uniform for every open swarm —
+     * the only per-frame JS cost regardless of iteration count.
+     */
+    _ensureSwarmClock() {
+        if (this._swarmObserver) return;
+        this._swarmObserver = this.scene.onBeforeRenderObservable.add(() => {
+            const now = performance.now() * 0.001;
+            for (const bd of this.bubbles.values()) {
+                if (bd.swarm && bd.swarm.material) {
+                    bd.swarm.material.setFloat('time', now);
+                }
+            }
+        });
+    }
+
     // ─── Node Chain Creation ───────────────────────────────────────
 
     /**
@@ -323,6 +466,16 @@ class LoopBubbleRenderer {
                     entities.push(ent);
                 }
             }
+            // ── Loop aggregates: exact counts from the sampling runtime ──
+            // Hot loops only trace sampled iterations, so the per-LOOP count
+            // above undercounts; LOOP_AGG carries the true iteration total.
+            else if (step.type === 'LOOP_AGG') {
+                const loopKey = `${step.subtype || 'loop'}|${step.condition || ''}`;
+                const ent = loopMap.get(loopKey);
+                if (ent && step.iterations !== null) {
+                    ent.iterations = Math.max(ent.iterations, step.iterations);
+                }
+            }
         }
 
         return entities;
@@ -829,6 +982,12 @@ class LoopBubbleRenderer {
             bubbleData.entryConnector.dispose();
         }
 
+        // Dispose iteration swarm (material is per-bubble, not cached)
+        if (bubbleData.swarm) {
+            if (bubbleData.swarm.material) bubbleData.swarm.material.dispose();
+            bubbleData.swarm.dispose();
+        }
+
         // Dispose all nodes
         if (bubbleData.nodes) {
             bubbleData.nodes.forEach(nodeData => {
@@ -259,6 +259,67 @@ class MeshFactory {
         return path;
     }
 
+    // ─── Thin-instance archetype masters ───────────────────────────
+
+    /**
+     * Create one hidden master mesh per building archetype for
+     * thin-instance rendering (large traces).
+     *
+     * Each master is unit-sized with its base at y = 0, so a per-instance
+     * scale×translate matrix reproduces the silhouette the individual
+     * builders make. Per-instance colour comes from a thin-instance
+     * "color" buffer; CityRenderer owns the matrices and buffers.
+     */
+    createArchetypeMasters() {
+        return {
+            function: this._archetypeMaster('function', () =>
+                BABYLON.MeshBuilder.CreateCylinder('master_function', {
+                    height: 1, diameterTop: 0.5, diameterBottom: 1,
+                    tessellation: 4, subdivisions: 1
+                }, this.scene)),
+            variable: this._archetypeMaster('variable', () =>
+                BABYLON.MeshBuilder.CreateBox('master_variable', {
+                    height: 1, width: 1, depth: 1
+                }, this.scene)),
+            loop: this._archetypeMaster('loop', () =>
+                BABYLON.MeshBuilder.CreateCylinder('master_loop', {
+                    height: 1, diameterTop: 0.75, diameterBottom: 1, tessellation: 6
+                }, this.scene)),
+            while: this._archetypeMaster('while', () =>
+                BABYLON.MeshBuilder.CreateCylinder('master_while', {
+                    height: 1, diameterTop: 0.75, diameterBottom: 1, tessellation: 6
+                }, this.scene)),
+            branch: this._archetypeMaster('branch', () =>
+                BABYLON.MeshBuilder.CreateCylinder('master_branch', {
+                    height: 1, diameterTop: 0.14, diameterBottom: 1, tessellation: 4
+                }, this.scene)),
+            console: this._archetypeMaster('console', () =>
+                BABYLON.MeshBuilder.CreateSphere('master_console', {
+                    diameter: 1, segments: 8
+                }, this.scene))
+        };
+    }
+
+    _archetypeMaster(type, build) {
+        const mesh = build();
+        // Base at y = 0 so instance matrices only need (scale, translate)
+        mesh.bakeTransformIntoVertices(BABYLON.Matrix.Translation(0, 0.5, 0));
+
+        // Colour comes from the per-instance buffer; keep the material
+        // neutral with a soft emissive so instances read in the dark scene.
+        const mat = new BABYLON.StandardMaterial(`masterMat_${type}`, this.scene);
+        mat.diffuseColor = new BABYLON.Color3(1, 1, 1);
+        mat.emissiveColor = new BABYLON.Color3(0.3, 0.3, 0.3);
+        mat.specularColor = new BABYLON.Color3(0.4, 0.4, 0.4);
+        mesh.material = mat;
+
+        mesh.thinInstanceEnablePicking = true;
+        mesh.isPickable = true;
+        mesh.isVisible = false;           // until instances are assigned
+        mesh._isArchetypeMaster = type;   // hover picking marker
+        return mesh;
+    }
+
     // ─── Static child-step helpers ─────────────────────────────────
 
     static fnChildSteps(fn) {
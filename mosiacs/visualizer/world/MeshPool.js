@@ -0,0 +1,66 @@
+/**
+ * MeshPool — free-list reuse for meshes whose geometry is fixed per kind.
+ *
+ * Warping in and out of galaxies used to dispose and recreate every
+ * building mesh, so each warp paid full geometry construction again.
+ * Galaxy buildings all come in a handful of fixed shapes, which makes
+ * them ideal pool candidates: instead of disposing, a mesh is hidden
+ * and parked on a free list keyed by its kind, then handed back out on
+ * the next warp with only position/material/metadata reassigned.
+ */
+class MeshPool {
+    constructor(scene) {
+        this.scene = scene;
+        this._free = new Map();   // kind → [mesh, ...]
+    }
+
+    /**
+     * Get a mesh of the given kind, reusing a parked one if available.
+     * `create` builds a fresh mesh (geometry + any baked transforms)
+     * when the free list is empty; the pool tags it for later release.
+     */
+    acquire(kind, create) {
+        const list = this._free.get(kind);
+        if (list && list.length > 0) {
+            const mesh = list.pop();
+            mesh.setEnabled(true);
+            mesh.isVisible = true;
+            return mesh;
+        }
+        const mesh = create();
+        mesh._poolKind = kind;
+        return mesh;
+    }
+
+    /**
+     * Park a mesh for reuse. Returns false (caller should dispose) if
+     * the mesh was not acquired from this pool or is already gone.
+     */
+    release(mesh) {
+        if (!mesh || mesh.isDisposed() || !mesh._poolKind) return false;
+        this.scene.stopAnimation(mesh);
+        if (mesh.unfreezeWorldMatrix) mesh.unfreezeWorldMatrix();
+        mesh.setEnabled(false);
+        mesh.isVisible = false;
+        mesh.isPickable = false;
+        let list = this._free.get(mesh._poolKind);
+        if (!list) {
+            list = [];
+            this._free.set(mesh._poolKind, list);
+        }
+        list.push(mesh);
+        return true;
+    }
+
+    /**
+     * Dispose everything parked in the pool (full teardown only).
+     */
+    drain() {
+        this._free.forEach(list => {
+            for (const mesh of list) {
+                if (mesh && !mesh.isDisposed()) mesh.dispose();
+            }
+        });
+        this._free.clear();
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * PickGrid — spatial index for hover/selection picking.
+ *
+ * `scene.pick` with a predicate walks every mesh in the scene per query,
+ * so on dense cities mouse movement alone burned a core. The grid hashes
+ * pickable meshes into XZ cells sized to the spiral layout; a query casts
+ * the picking ray through the cells it actually crosses (2D DDA over the
+ * ray's ground projection) and tests bounding spheres before touching
+ * real geometry. Thin-instance masters, whose bounds span many cells,
+ * live in a small always-tested overflow list, so the precise
+ * per-instance intersection still runs only when the ray is near them.
+ *
+ * The index rebuilds itself when the scene's mesh count changes and on a
+ * slow timer (meshes animate and warp in/out), which keeps registration
+ * out of every renderer: the grid reads the same `_buildingData`-style
+ * flags the old predicate did.
+ */
+class PickGrid {
+    constructor(scene, cellSize = 10) {
+        this.scene = scene;
+        this.cellSize = cellSize;
+        this.rebuildInterval = 2000;   // ms between staleness rebuilds
+        this.maxCellSpan = 24;         // wider AABBs go to the overflow list
+        this.maxSteps = 512;           // DDA traversal cap
+
+        this._cells = new Map();       // "cx,cz" → [mesh, ...]
+        this._large = [];              // meshes too wide to bucket
+        this._meshCount = -1;          // scene.meshes.length at last build
+        this._builtAt = 0;
+        this._queryId = 0;             // per-query dedup stamp
+    }
+
+    /**
+     * Pick the nearest mesh passing `predicate` under screen point (x, y).
+     * Returns a Babylon PickingInfo (distance, thinInstanceIndex, …) or
+     * null when the ray hits nothing.
+     */
+    pick(x, y, predicate) {
+        const now = Date.now();
+        if (this.scene.meshes.length !== this._meshCount ||
+            now - this._builtAt > this.rebuildInterval) {
+            this._rebuild(predicate);
+            this._builtAt = now;
+        }
+
+        const ray = this.scene.createPickingRay(
+            x, y, BABYLON.Matrix.Identity(), this.scene.activeCamera);
+
+        const stamp = ++this._queryId;
+        let best = null;
+        const test = (mesh) => {
+            if (mesh._pickStamp === stamp) return;
+            mesh._pickStamp = stamp;
+            if (mesh.isDisposed() || !mesh.isEnabled() || !mesh.isVisible) return;
+            if (!ray.intersectsSphere(mesh.getBoundingInfo().boundingSphere)) return;
+            const info = ray.intersectsMesh(mesh);
+            if (info.hit && (best === null || info.distance < best.distance)) {
+                best = info;
+            }
+        };
+
+        for (const mesh of this._large) test(mesh);
+        this._walkCells(ray, (cell) => {
+            for (const mesh of cell) test(mesh);
+            return best ? best.distance : Infinity;
+        });
+        return best;
+    }
+
+    /** Drop the index; the next query rebuilds from the live scene. */
+    invalidate() {
+        this._meshCount = -1;
+    }
+
+    // ─── Index construction ────────────────────────────────────────
+
+    _rebuild(predicate) {
+        this._cells.clear();
+        this._large.length = 0;
+        this._meshCount = this.scene.meshes.length;
+
+        for (const mesh of this.scene.meshes) {
+            if (!predicate(mesh)) continue;
+            if (mesh.isDisposed() || !mesh.isEnabled() || !mesh.isVisible || !mesh.isPickable) continue;
+
+            const box = mesh.getBoundingInfo().boundingBox;
+            const minX = Math.floor(box.minimumWorld.x / this.cellSize);
+            const maxX = Math.floor(box.maximumWorld.x / this.cellSize);
+            const minZ = Math.floor(box.minimumWorld.z / this.cellSize);
+            const maxZ = Math.floor(box.maximumWorld.z / this.cellSize);
+
+            if ((maxX - minX) > this.maxCellSpan || (maxZ - minZ) > this.maxCellSpan) {
+                this._large.push(mesh);
+                continue;
+            }
+            for (let cx = minX; cx <= maxX; cx++) {
+                for (let cz = minZ; cz <= maxZ; cz++) {
+                    const key = cx + "," + cz;
+                    let cell = this._cells.get(key);
+                    if (!cell) {
+                        cell = [];
+                        this._cells.set(key, cell);
+                    }
+                    cell.push(mesh);
+                }
+            }
+        }
+    }
+
+    // ─── Traversal ─────────────────────────────────────────────────
+
+    /**
+     * Visit the occupied cells the ray's XZ projection crosses, near to
+     * far (Amanatides–Woo stepping). A near-vertical ray degenerates to
+     * the single column under the camera, which is exactly right.
+     * `visit` returns the best hit distance so far; traversal stops once
+     * every remaining cell starts beyond it.
+     */
+    _walkCells(ray, visit) {
+        const size = this.cellSize;
+        const dx = ray.direction.x;
+        const dz = ray.direction.z;
+
+        let cx = Math.floor(ray.origin.x / size);
+        let cz = Math.floor(ray.origin.z / size);
+        const stepX = dx > 0 ? 1 : -1;
+        const stepZ = dz > 0 ? 1 : -1;
+
+        // Distance along the ray to the next cell boundary on each axis.
+        const nextX = (cx + (dx > 0 ? 1 : 0)) * size;
+        const nextZ = (cz + (dz > 0 ? 1 : 0)) * size;
+        let tMaxX = dx !== 0 ? (nextX - ray.origin.x) / dx : Infinity;
+        let tMaxZ = dz !== 0 ? (nextZ - ray.origin.z) / dz : Infinity;
+        const tDeltaX = dx !== 0 ? Math.abs(size / dx) : Infinity;
+        const tDeltaZ = dz !== 0 ? Math.abs(size / dz) : Infinity;
+
+        let best = Infinity;
+        for (let i = 0; i < this.maxSteps; i++) {
+            const cell = this._cells.get(cx + "," + cz);
+            if (cell) best = visit(cell);
+            if (tMaxX === Infinity && tMaxZ === Infinity) break;
+            const tNext = Math.min(tMaxX, tMaxZ);
+            if (tNext > ray.length || tNext > best) break;
+            if (tMaxX < tMaxZ) {
+                cx += stepX;
+                tMaxX += tDeltaX;
+            } else {
+                cz += stepZ;
+                tMaxZ += tDeltaZ;
+            }
+        }
+    }
+}
@@ -453,55 +453,22 @@ class SubSpiralRenderer {
 
     /**
      * Animate a single bubble flowing along the spiral path.
-     * Uses requestAnimationFrame for smooth interpolation.
+     * Keyframes are baked once (BubbleAnimator) and evaluated by the
+     * scene's animation engine — no per-frame JS per bubble.
      * Returns an object with a cancel method.
      */
     _animateBubbleAlongPath(bubble, pathPoints, index, totalBubbles, parentKey) {
         const duration = this.bubbleDuration + Math.random() * this.bubbleDurationVariance;
-        const staggerDelay = (index / totalBubbles) * duration;
-
-        let startTime = null;
-        let cancelled = false;
-
-        const animate = (time) => {
-            if (cancelled || bubble.isDisposed()) return;
-
-            if (!startTime) startTime = time - staggerDelay;
-
-            const elapsed = time - startTime;
-            const loopTime = elapsed % duration;
-            const t = loopTime / duration;  // 0 → 1 along path
-
-            // Interpolate position along the path
-            const pathProgress = t * (pathPoints.length - 1);
-            const segmentIndex = Math.floor(pathProgress);
-            const segmentFrac = pathProgress - segmentIndex;
-
-            if (segmentIndex < pathPoints.length - 1) {
-                const p0 = pathPoints[segmentIndex];
-                const p1 = pathPoints[segmentIndex + 1];
-                bubble.position = BABYLON.Vector3.Lerp(p0, p1, segmentFrac);
-            } else {
-                bubble.position = pathPoints[pathPoints.length - 1].clone();
-            }
-
-            // Gentle pulsing scale for organic "floating" feel
-            const pulse = 1 + Math.sin(time * 0.006 + index) * 0.2;
-            bubble.scaling.setAll(pulse);
-
-            // Slight alpha variation for shimmer effect
-            if (bubble.material) {
-                bubble.material.alpha = 0.5 + Math.sin(time * 0.004 + index * 0.5) * 0.2;
-            }
-
-            requestAnimationFrame(animate);
-        };
-
-        requestAnimationFrame(animate);
+        const animatable = BubbleAnimator.animate(this.scene, bubble, pathPoints, {
+            duration,
+            stagger: index / totalBubbles,
+            pulse: { amp: 0.2, period: 1050, phase: index },
+            shimmer: { base: 0.5, amp: 0.2, period: 1570, phase: index * 0.5 }
+        });
 
         // Return cancel handle
         return {
-            cancel: () => { cancelled = true; }
+            cancel: () => animatable.stop()
         };
     }
 
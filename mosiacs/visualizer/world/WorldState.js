@@ -24,6 +24,8 @@ class WorldState {
         this.branchIntersections = new Map();
         this.memoryNodes = new Map();
         this.consoleOutputs = new Map();  // UNKNOWN events (console output)
+        // Interned address table (ADDR records): token → { address, size }
+        this.addressTable = new Map();
 
         // Invocation counters for unique keys
         this._fnCallCount = new Map();
@@ -37,6 +39,15 @@ class WorldState {
         // Track "active" containers for sub-step recording
         this._containerStack = [];
 
+        // Precomputed scope nesting (see normalize.py CallTreeIndex):
+        // node id → { key, type, parent, children } for every container
+        // opened so far, keyed by the `node` id stamped on its opening
+        // record. Steps stamped with a `scope` id attribute themselves
+        // through this map; traces without the stamps fall back to the
+        // container stack.
+        this._scopeNodes = new Map();
+        this._currentStepScope = null;
+
         this.processedSteps = [];
 
         // ─── READ relation tracking ───────────────────────────────
@@ -55,6 +66,16 @@ class WorldState {
 
         // Error information from compilation/runtime failures
         this.error = null;
+
+        // ─── Keyframe snapshots for O(delta) seeking ──────────────
+        // Full state cloned every _keyframeInterval applied steps, so a
+        // backward seek restores the nearest keyframe and replays only
+        // the remainder instead of the whole trace. When the cap is hit
+        // every other keyframe is dropped and the interval doubles, so
+        // memory stays bounded on very long traces.
+        this._keyframes = [];
+        this._keyframeInterval = 1000;
+        this._maxKeyframes = 48;
     }
 
     loadTrace(trace, error = null) {
@@ -63,7 +84,24 @@ class WorldState {
         this.reset();
     }
 
+    /**
+     * Append more steps to the loaded trace without resetting state.
+     * Used by windowed loading: earlier windows stay applied, so seeking
+     * forward after an append only replays the newly-arrived steps.
+     */
+    appendTrace(steps) {
+        if (!steps || steps.length === 0) return;
+        for (const s of steps) this.trace.push(s);
+    }
+
     reset() {
+        this._resetState();
+        this._keyframes = [];
+        this._keyframeInterval = 1000;
+    }
+
+    /** Clear applied state only — keyframes for the loaded trace survive. */
+    _resetState() {
         this.currentStep = -1;
         this.functionDistricts.clear();
         this.variableHouses.clear();
@@ -72,12 +110,15 @@ class WorldState {
         this.branchIntersections.clear();
         this.memoryNodes.clear();
         this.consoleOutputs.clear();
+        this.addressTable.clear();
         this._fnCallCount.clear();
         this._forLoopCount.clear();
         this._whileLoopCount.clear();
         this._condCount.clear();
         this.callStack = [];
         this._containerStack = [];
+        this._scopeNodes.clear();
+        this._currentStepScope = null;
         this.processedSteps = [];
         this._pendingReads = [];
         this.readRelations = [];
@@ -86,11 +127,28 @@ class WorldState {
 
     seekTo(targetStep) {
         targetStep = Math.max(-1, Math.min(targetStep, this.trace.length - 1));
-        if (targetStep < this.currentStep) this.reset();
+        if (targetStep < this.currentStep) {
+            const kf = this._nearestKeyframe(targetStep);
+            if (kf) this._restoreKeyframe(kf);
+            else this._resetState();
+        }
         while (this.currentStep < targetStep) this._applyStep(this.currentStep + 1);
     }
 
     currentScope() {
+        // Prefer the scope id stamped on the step being applied: walk the
+        // precomputed chain to the innermost enclosing function. Traces
+        // without the stamps derive it from the replayed call stack.
+        let nid = this._currentStepScope;
+        if (nid !== null && this._scopeNodes.size > 0) {
+            while (nid >= 0) {
+                const node = this._scopeNodes.get(nid);
+                if (!node) break;
+                if (node.type === 'function') return node.key;
+                nid = node.parent;
+            }
+            if (nid < 0) return '__global__';
+        }
         return this.callStack.length > 0
             ? this.callStack[this.callStack.length - 1]
             : '__global__';
@@ -102,10 +160,22 @@ class WorldState {
         const step = this.trace[index];
         this.currentStep = index;
         this.processedSteps.push(step);
-
-        // Record this step index on all open containers
-        for (const c of this._containerStack) {
-            c.children.push(index);
+        this._currentStepScope = typeof step.scope === 'number' ? step.scope : null;
+
+        // Record this step index on all open containers. Stamped traces
+        // name their ancestor chain directly (see CallTreeIndex in
+        // normalize.py); older traces replay it off the container stack.
+        if (this._currentStepScope !== null && this._scopeNodes.size > 0) {
+            for (let nid = this._currentStepScope; nid >= 0; ) {
+                const node = this._scopeNodes.get(nid);
+                if (!node) break;
+                node.children.push(index);
+                nid = node.parent;
+            }
+        } else {
+            for (const c of this._containerStack) {
+                c.children.push(index);
+            }
         }
 
         switch (step.type) {
@@ -119,8 +189,143 @@ class WorldState {
             case 'CONDITION':    this._handleCondition(step); break;
             case 'BRANCH':       this._handleBranch(step); break;
             case 'EXTERNAL_CALL': this._handleExternalCall(step); break;
+            case 'RUN':          this._handleRun(step); break;
+            case 'ADDR':         this._handleAddr(step); break;
             case 'UNKNOWN':      this._handleUnknown(step); break;
         }
+
+        if ((index + 1) % this._keyframeInterval === 0) this._captureKeyframe();
+    }
+
+    // ─── Keyframes ─────────────────────────────────────────────────
+
+    _captureKeyframe() {
+        const last = this._keyframes[this._keyframes.length - 1];
+        if (last && this.currentStep <= last.step) return;  // replaying past one
+
+        // One structuredClone over the whole bundle, so aliasing between
+        // container-stack `children` arrays and the entities'
+        // childStepIndices they point into survives the copy.
+        this._keyframes.push(structuredClone({
+            step: this.currentStep,
+            functionDistricts: this.functionDistricts,
+            variableHouses: this.variableHouses,
+            forLoopFactories: this.forLoopFactories,
+            whileLoopFactories: this.whileLoopFactories,
+            branchIntersections: this.branchIntersections,
+            memoryNodes: this.memoryNodes,
+            consoleOutputs: this.consoleOutputs,
+            addressTable: this.addressTable,
+            fnCallCount: this._fnCallCount,
+            forLoopCount: this._forLoopCount,
+            whileLoopCount: this._whileLoopCount,
+            condCount: this._condCount,
+            callStack: this.callStack,
+            containerStack: this._containerStack,
+            scopeNodes: this._scopeNodes,
+            currentStepScope: this._currentStepScope,
+            pendingReads: this._pendingReads,
+            readRelations: this.readRelations,
+            creationOrder: this.creationOrder
+        }));
+
+        if (this._keyframes.length > this._maxKeyframes) {
+            this._keyframes = this._keyframes.filter((_, i) => i % 2 === 0);
+            this._keyframeInterval *= 2;
+        }
+    }
+
+    _nearestKeyframe(targetStep) {
+        let best = null;
+        for (const kf of this._keyframes) {
+            if (kf.step > targetStep) break;
+            best = kf;
+        }
+        return best;
+    }
+
+    _restoreKeyframe(kf) {
+        // Clone again on the way out — the live state mutates freely and
+        // must never write through into the stored keyframe.
+        const s = structuredClone(kf);
+        this.currentStep = s.step;
+        this.functionDistricts = s.functionDistricts;
+        this.variableHouses = s.variableHouses;
+        this.forLoopFactories = s.forLoopFactories;
+        this.whileLoopFactories = s.whileLoopFactories;
+        this.branchIntersections = s.branchIntersections;
+        this.memoryNodes = s.memoryNodes;
+        this.consoleOutputs = s.consoleOutputs;
+        this.addressTable = s.addressTable;
+        this._fnCallCount = s.fnCallCount;
+        this._forLoopCount = s.forLoopCount;
+        this._whileLoopCount = s.whileLoopCount;
+        this._condCount = s.condCount;
+        this.callStack = s.callStack;
+        this._containerStack = s.containerStack;
+        this._scopeNodes = s.scopeNodes;
+        this._currentStepScope = s.currentStepScope;
+        this._pendingReads = s.pendingReads;
+        this.readRelations = s.readRelations;
+        this.creationOrder = s.creationOrder;
+        // processedSteps is always trace[0..currentStep] in order — rebuild
+        // from the trace instead of storing a copy in every keyframe.
+        this.processedSteps = this.trace.slice(0, s.step + 1);
+    }
+
+    // ─── RUN — folded repetitive records (lazy expansion) ──────────
+
+    /**
+     * A RUN record is a server-side fold of consecutive structurally
+     * identical records (see RunFolder in normalize.py): a template plus
+     * per-record deltas. Expand it here, record by record, dispatching
+     * each reconstructed step to its normal handler. All expanded
+     * records share the run's step index — value histories stay intact,
+     * the trace array just carries one entry for the whole run.
+     */
+    _handleRun(step) {
+        if (!step.runOf || !step.raw) return;
+        const deltas = step.deltas || [];
+        const count = step.count || deltas.length;
+
+        for (let i = 0; i < count; i++) {
+            const sub = { ...step.raw, ...(deltas[i] || null) };
+            const subStep = {
+                ...step,
+                type: step.runOf,
+                name: sub.subject || '',
+                value: sub.value !== undefined ? String(sub.value) : '',
+                address: sub.address || '0',
+                line: Number(sub.line_number) || 0,
+                depth: Number(sub.stack_depth) || 0,
+                subtype: sub.subtype || '',
+                condition: sub.condition || '',
+                conditionResult: sub.condition_result !== undefined ? Number(sub.condition_result) : null,
+                readValue: sub.format_spec !== undefined ? String(sub.format_spec) : ''
+            };
+
+            switch (step.runOf) {
+                case 'ASSIGN': this._handleAssign(subStep); break;
+                case 'READ':   this._handleRead(subStep); break;
+                case 'LOOP':   this._handleLoop(subStep); break;
+                case 'DECL':   this._handleDecl(subStep); break;
+                // UPDATE records have never driven world state — keep it so
+            }
+        }
+    }
+
+    /**
+     * ADDR record: the runtime interned a new address. Later records carry
+     * the token (a<id>) in their address field, so variable and memory-node
+     * identity is already stable — this just keeps the raw address and
+     * object size around for inspection.
+     */
+    _handleAddr(step) {
+        if (!step.address || step.address === '0') return;
+        this.addressTable.set(step.address, {
+            address: step.value,
+            size: step.size || 0
+        });
     }
 
     // ─── helpers ───────────────────────────────────────────────────
@@ -131,6 +336,21 @@ class WorldState {
         return n;
     }
 
+    /**
+     * Register a container under the node id stamped on its opening
+     * record, so later steps can attribute themselves via their scope
+     * chain. `children` is the entity's own childStepIndices array —
+     * chain attribution writes straight into it, same as the container
+     * stack does.
+     */
+    _registerScopeNode(step, type, key, children) {
+        if (typeof step.node === 'number' && step.node >= 0) {
+            this._scopeNodes.set(step.node, {
+                key, type, parent: step.scope, children
+            });
+        }
+    }
+
     // ─── CALL — new building per invocation ────────────────────────
 
     _handleCall(step) {
@@ -161,6 +381,8 @@ class WorldState {
             endStep: null,
             children: this.functionDistricts.get(key).childStepIndices
         });
+        this._registerScopeNode(step, 'function', key,
+            this.functionDistricts.get(key).childStepIndices);
     }
 
     // ─── EXTERNAL_CALL — library/external function calls ───────────
@@ -450,6 +672,7 @@ class WorldState {
                 endStep: null,
                 children: factory.childStepIndices
             });
+            this._registerScopeNode(step, typeTag, key, factory.childStepIndices);
         } else {
             // condition_result == 0 → loop ends
             if (activeKey) {
@@ -487,6 +710,9 @@ class WorldState {
             childStepIndices: [],
             chainLinks: [],
             _baseLookup: baseLookup,
+            // Precomputed scope node this condition opened — the branch
+            // renderer uses it to tell chain members from nested steps.
+            nodeId: typeof step.node === 'number' ? step.node : null,
             line: step.line || 0,
             sourceFile: step.sourceFile
         };
@@ -500,6 +726,7 @@ class WorldState {
             endStep: null,
             children: intersection.childStepIndices
         });
+        this._registerScopeNode(step, 'branch', key, intersection.childStepIndices);
     }
 
     // ─── BRANCH ────────────────────────────────────────────────────
@@ -16,6 +16,10 @@ class GalaxyBuilder {
         // Material cache for performance
         this._matCache = new Map();
 
+        // Mesh pool — galaxy buildings have fixed geometry per type,
+        // so warps reuse parked meshes instead of rebuilding them
+        this._meshPool = new MeshPool(scene);
+
         // Meshes created during build
         this._galaxyMeshes = [];
         this._galaxyExtraMeshes = [];
@@ -252,48 +256,17 @@ class GalaxyBuilder {
 
     /**
      * Animate a single bubble flowing along the spiral path.
+     * Keyframes are baked once (BubbleAnimator) and evaluated by the
+     * scene's animation engine — no per-frame JS per bubble.
      */
     _animateBubbleAlongPath(bubble, pathPoints, index, totalBubbles) {
         const duration = this.bubbleDuration + Math.random() * this.bubbleDurationVariance;
-        const staggerDelay = (index / totalBubbles) * duration;
-
-        let startTime = null;
-
-        const animate = (time) => {
-            if (bubble.isDisposed()) return;
-
-            if (!startTime) startTime = time - staggerDelay;
-
-            const elapsed = time - startTime;
-            const loopTime = elapsed % duration;
-            const t = loopTime / duration;  // 0 → 1 along path
-
-            // Interpolate position along the path
-            const pathProgress = t * (pathPoints.length - 1);
-            const segmentIndex = Math.floor(pathProgress);
-            const segmentFrac = pathProgress - segmentIndex;
-
-            if (segmentIndex < pathPoints.length - 1) {
-                const p0 = pathPoints[segmentIndex];
-                const p1 = pathPoints[segmentIndex + 1];
-                bubble.position = BABYLON.Vector3.Lerp(p0, p1, segmentFrac);
-            } else {
-                bubble.position = pathPoints[pathPoints.length - 1].clone();
-            }
-
-            // Gentle pulsing scale for organic "floating" feel
-            const pulse = 1 + Math.sin(time * 0.005 + index * 1.5) * 0.25;
-            bubble.scaling.setAll(pulse);
-
-            // Slight alpha variation for shimmer effect
-            if (bubble.material) {
-                bubble.material.alpha = 0.55 + Math.sin(time * 0.003 + index * 0.7) * 0.2;
-            }
-
-            requestAnimationFrame(animate);
-        };
-
-        requestAnimationFrame(animate);
+        BubbleAnimator.animate(this.scene, bubble, pathPoints, {
+            duration,
+            stagger: index / totalBubbles,
+            pulse: { amp: 0.25, period: 1260, phase: index * 1.5 },
+            shimmer: { base: 0.55, amp: 0.2, period: 2090, phase: index * 0.7 }
+        });
     }
 
     /**
@@ -396,20 +369,25 @@ class GalaxyBuilder {
         switch (entity.type) {
             case 'variable': {
                 const height = 2.0;
-                mesh = BABYLON.MeshBuilder.CreateBox(
-                    `galaxy_var_${parentKey}_${index}`,
-                    { height, width: 1.5, depth: 1.5 },
-                    this.scene
+                mesh = this._meshPool.acquire('galaxy_var', () =>
+                    BABYLON.MeshBuilder.CreateBox(
+                        'galaxy_var',
+                        { height, width: 1.5, depth: 1.5 },
+                        this.scene
+                    )
                 );
                 mesh.position = pos.clone();
                 mesh.position.y += height / 2;
 
-                const roof = BABYLON.MeshBuilder.CreateCylinder(
-                    `galaxy_varRoof_${parentKey}_${index}`,
-                    { height: 0.6, diameterTop: 0, diameterBottom: 2.0, tessellation: 4 },
-                    this.scene
-                );
-                roof.bakeTransformIntoVertices(BABYLON.Matrix.RotationY(Math.PI / 4));
+                const roof = this._meshPool.acquire('galaxy_varRoof', () => {
+                    const m = BABYLON.MeshBuilder.CreateCylinder(
+                        'galaxy_varRoof',
+                        { height: 0.6, diameterTop: 0, diameterBottom: 2.0, tessellation: 4 },
+                        this.scene
+                    );
+                    m.bakeTransformIntoVertices(BABYLON.Matrix.RotationY(Math.PI / 4));
+                    return m;
+                });
                 roof.position = pos.clone();
                 roof.position.y += height + 0.3;
                 roof.material = this._getCachedMat('varRoof', {
@@ -424,10 +402,12 @@ class GalaxyBuilder {
             }
             case 'loop': {
                 const height = 3.0;
-                mesh = BABYLON.MeshBuilder.CreateCylinder(
-                    `galaxy_loop_${parentKey}_${index}`,
-                    { height, diameterTop: 2.0 * 0.75, diameterBottom: 2.0, tessellation: 6 },
-                    this.scene
+                mesh = this._meshPool.acquire('galaxy_loop', () =>
+                    BABYLON.MeshBuilder.CreateCylinder(
+                        'galaxy_loop',
+                        { height, diameterTop: 2.0 * 0.75, diameterBottom: 2.0, tessellation: 6 },
+                        this.scene
+                    )
                 );
                 mesh.position = pos.clone();
                 mesh.position.y += height / 2;
@@ -436,22 +416,27 @@ class GalaxyBuilder {
             case 'call':
             case 'return': {
                 const height = 3.5;
-                mesh = BABYLON.MeshBuilder.CreateCylinder(
-                    `galaxy_call_${parentKey}_${index}`,
-                    { height, diameterTop: 1.0, diameterBottom: 2.5, tessellation: 4 },
-                    this.scene
-                );
-                const bake = BABYLON.Matrix.RotationY(Math.PI / 4)
-                    .multiply(BABYLON.Matrix.Translation(0, height / 2, 0));
-                mesh.bakeTransformIntoVertices(bake);
+                mesh = this._meshPool.acquire('galaxy_call', () => {
+                    const m = BABYLON.MeshBuilder.CreateCylinder(
+                        'galaxy_call',
+                        { height, diameterTop: 1.0, diameterBottom: 2.5, tessellation: 4 },
+                        this.scene
+                    );
+                    const bake = BABYLON.Matrix.RotationY(Math.PI / 4)
+                        .multiply(BABYLON.Matrix.Translation(0, height / 2, 0));
+                    m.bakeTransformIntoVertices(bake);
+                    return m;
+                });
                 mesh.position = pos.clone();
                 break;
             }
             default: {
-                mesh = BABYLON.MeshBuilder.CreateSphere(
-                    `galaxy_gen_${parentKey}_${index}`,
-                    { diameter: 1.8, segments: 6 },
-                    this.scene
+                mesh = this._meshPool.acquire('galaxy_gen', () =>
+                    BABYLON.MeshBuilder.CreateSphere(
+                        'galaxy_gen',
+                        { diameter: 1.8, segments: 6 },
+                        this.scene
+                    )
                 );
                 mesh.position = pos.clone();
                 mesh.position.y += 0.9;
@@ -464,16 +449,28 @@ class GalaxyBuilder {
         mesh._isGalaxyBuilding = true;
         mesh._entityData = entity;
 
-        // Create floating label
+        // Create floating label — pooled per colour type so the
+        // DynamicTexture (the expensive part) survives across warps;
+        // reused planes only get their text redrawn.
         const labelText = entity.label || entity.subject || entity.type;
-        const label = this.labelHelper.create(
-            `galaxy_label_${parentKey}_${index}`,
-            labelText,
-            mesh.position.clone(),
-            3.5,
-            color,
-            0.5
-        );
+        const label = this._meshPool.acquire(`galaxy_label_${colorType}`, () => {
+            const plane = this.labelHelper.create(
+                `galaxy_label_${colorType}`,
+                labelText,
+                mesh.position.clone(),
+                3.5,
+                color,
+                0.5
+            );
+            plane._labelText = labelText;
+            return plane;
+        });
+        if (label._labelText !== labelText) {
+            this.labelHelper.update(label, labelText);
+            label._labelText = labelText;
+        }
+        label.position = mesh.position.clone();
+        label.position.y += 3.5;
         label.isVisible = false;
         label.isPickable = false;
         mesh._label = label;
@@ -645,6 +642,48 @@ class GalaxyBuilder {
         this._pendingTimers = [];
     }
 
+    /**
+     * Return a galaxy's meshes to the pool where possible, disposing
+     * the rest. Buildings, roofs and labels have fixed geometry and are
+     * parked for the next warp; the spiral tube, causality lines and
+     * flow bubbles are path-dependent and rebuilt every time.
+     */
+    releaseGalaxy(galaxyData) {
+        if (!galaxyData) return;
+        const cachedMats = new Set(this._matCache.values());
+
+        for (const mesh of galaxyData.meshes || []) {
+            if (!mesh || mesh.isDisposed()) continue;
+
+            if (this._meshPool.release(mesh)) {
+                // Per-warp state must not leak into the next reuse
+                mesh._entityData = null;
+                mesh._galaxyChildIndices = null;
+                mesh._galaxySubTrace = null;
+                mesh._label = null;
+                continue;
+            }
+
+            this.scene.stopAnimation(mesh);
+            if (mesh.material) {
+                if (!cachedMats.has(mesh.material)) {
+                    if (mesh.material.diffuseTexture) mesh.material.diffuseTexture.dispose();
+                    mesh.material.dispose();
+                } else {
+                    mesh.material = null;
+                }
+            }
+            mesh.dispose();
+        }
+    }
+
+    /**
+     * Dispose pooled meshes (full teardown only)
+     */
+    drainMeshPool() {
+        this._meshPool.drain();
+    }
+
     /**
      * Dispose cached materials
      */
@@ -659,6 +698,7 @@ class GalaxyBuilder {
     disposeBubbles() {
         for (const bubble of this._bubbles) {
             if (bubble && !bubble.isDisposed()) {
+                this.scene.stopAnimation(bubble);
                 if (bubble.material) bubble.material.dispose();
                 bubble.dispose();
             }
@@ -615,25 +615,9 @@ class GalaxyWarpManager {
             const treeKey = galaxy.entity.key || 'tree';
             this.mainCityRenderer.branchTreeRenderer.removeTree(treeKey);
         } else {
-            // Traditional galaxy disposal
-            const cachedMats = new Set(this.galaxyBuilder._matCache.values());
-
-            // Dispose galaxy meshes
-            const allMeshes = galaxy.galaxyData.meshes || [];
-            for (const mesh of allMeshes) {
-                if (mesh && !mesh.isDisposed()) {
-                    this.scene.stopAnimation(mesh);
-                    if (mesh.material) {
-                        if (!cachedMats.has(mesh.material)) {
-                            if (mesh.material.diffuseTexture) mesh.material.diffuseTexture.dispose();
-                            mesh.material.dispose();
-                        } else {
-                            mesh.material = null;
-                        }
-                    }
-                    mesh.dispose();
-                }
-            }
+            // Traditional galaxy teardown: buildings go back to the
+            // builder's mesh pool, path-dependent meshes are disposed
+            this.galaxyBuilder.releaseGalaxy(galaxy.galaxyData);
         }
 
         // Dispose warp effects using temporary instance
@@ -692,6 +676,9 @@ class GalaxyWarpManager {
             this._disposeWarpedGalaxy(this.warpedGalaxy);
         }
 
+        // Drain pooled meshes before their cached materials go away
+        this.galaxyBuilder.drainMeshPool();
+
         // Dispose cached materials
         this.galaxyBuilder.disposeMaterials();
 
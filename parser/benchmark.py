@@ -0,0 +1,375 @@
+"""Pipeline benchmark harness with per-stage regression tracking.
+
+Runs the instrument → compile → run → normalize pipeline over the
+tests/ corpus plus a few synthetic generators (deep recursion, hot
+loops, many variables) and reports wall time and peak RSS for each
+stage separately, so a slowdown in CInstrumenter or the normalizer is
+visible before it ships.
+
+Each stage executes in a forked child: wall time is measured around
+the stage body and peak RSS is read from getrusage (RUSAGE_CHILDREN
+covers gcc and the traced program). Absolute RSS numbers include the
+interpreter baseline inherited at fork — they are comparable run to
+run, which is what regression gating needs.
+
+Usage (from parser/):
+
+    python benchmark.py --update-baseline   # record current numbers
+    python benchmark.py                     # compare against baseline
+
+Comparison fails (exit 1) when a stage's wall time exceeds the
+baseline by --threshold (default 1.30x, with a small absolute floor to
+ignore noise on sub-millisecond stages) or its peak RSS by
+--rss-threshold (default 1.50x). Compilation is forced down the cold
+gcc path so daemon availability cannot skew the numbers.
+"""
+
+import argparse
+import fnmatch
+import json
+import os
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+from datetime import datetime, timezone
+
+import compiler
+import run
+from normalize import RunFolder, StreamNormalizer
+from tracer import binformat
+
+_TESTS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "tests")
+_DEFAULT_BASELINE = os.path.join(
+    os.path.dirname(os.path.abspath(__file__)), "benchmark_baseline.json"
+)
+
+# Corpus files that exist to exercise error paths, not performance.
+_SKIP = {"bad_c.c", "bad_extension.txt", "bad_syntax.c", "infinite_loop.c"}
+
+# Wall-time regressions smaller than this are treated as noise even
+# when the ratio trips the threshold.
+_SEC_FLOOR = 0.05
+
+
+# ── Synthetic workloads ─────────────────────────────────────────
+
+def _gen_deep_recursion():
+    return "\n".join(
+        [
+            "#include <stdio.h>",
+            "int descend(int depth, int acc) {",
+            "    if (depth <= 0) return acc;",
+            "    int next = acc + depth;",
+            "    return descend(depth - 1, next);",
+            "}",
+            "int main() {",
+            "    int total = descend(400, 0);",
+            '    printf("%d\\n", total);',
+            "    return 0;",
+            "}",
+        ]
+    )
+
+
+def _gen_hot_loops():
+    return "\n".join(
+        [
+            "#include <stdio.h>",
+            "int main() {",
+            "    long sum = 0;",
+            "    for (int i = 0; i < 200; i++) {",
+            "        for (int j = 0; j < 200; j++) {",
+            "            int cell = i * j;",
+            "            sum += cell;",
+            "        }",
+            "    }",
+            '    printf("%ld\\n", sum);',
+            "    return 0;",
+            "}",
+        ]
+    )
+
+
+def _gen_many_vars(count=300):
+    lines = ["#include <stdio.h>", "int main() {", "    int total = 0;"]
+    for i in range(count):
+        lines.append(f"    int v{i} = {i} * 3;")
+        lines.append(f"    total += v{i};")
+    lines.append('    printf("%d\\n", total);')
+    lines.append("    return 0;")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+_SYNTHETIC = {
+    "synthetic_deep_recursion.c": _gen_deep_recursion,
+    "synthetic_hot_loops.c": _gen_hot_loops,
+    "synthetic_many_vars.c": _gen_many_vars,
+}
+
+
+# ── Stage measurement ───────────────────────────────────────────
+
+def _measure(fn):
+    """Run fn() in a forked child; return {"sec", "rss_kb"} or {"error"}."""
+    rfd, wfd = os.pipe()
+    pid = os.fork()
+    if pid == 0:
+        os.close(rfd)
+        try:
+            t0 = time.monotonic()
+            fn()
+            elapsed = time.monotonic() - t0
+            rss = max(
+                resource.getrusage(resource.RUSAGE_SELF).ru_maxrss,
+                resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss,
+            )
+            os.write(wfd, json.dumps({"sec": elapsed, "rss_kb": rss}).encode())
+            os._exit(0)
+        except BaseException as e:  # report, never unwind into the parent
+            try:
+                os.write(wfd, json.dumps({"error": str(e) or repr(e)}).encode())
+            finally:
+                os._exit(1)
+    os.close(wfd)
+    with os.fdopen(rfd, "rb") as f:
+        payload = f.read()
+    os.waitpid(pid, 0)
+    try:
+        return json.loads(payload)
+    except (ValueError, TypeError):
+        return {"error": "stage child died without reporting"}
+
+
+def _bench_case(src_path, workdir):
+    """Benchmark one source file; return {stage: {"sec", "rss_kb"}}."""
+    ext = os.path.splitext(src_path)[1]
+    is_python = ext == ".py"
+    instrumented = os.path.join(workdir, "instrumented" + ext)
+    exe = os.path.join(workdir, "case.exe")
+    trace = os.path.join(workdir, "case.trace")
+
+    stages = {}
+
+    def do_instrument():
+        code, _ = run._instrument(src_path, "binary")
+        with open(instrumented, "w") as f:
+            f.write(code)
+
+    stages["instrument"] = _measure(do_instrument)
+    if "error" in stages["instrument"]:
+        return stages
+
+    if not is_python:
+        stages["compile"] = _measure(lambda: run._compile(instrumented, exe))
+        if "error" in stages["compile"]:
+            return stages
+
+    def do_run():
+        if is_python:
+            # Python traces arrive as text on stdout (same as deal()).
+            with open(trace, "wb") as f:
+                proc = subprocess.run(
+                    [sys.executable, instrumented],
+                    stdout=f,
+                    stderr=subprocess.DEVNULL,
+                    timeout=run._RUN_TIMEOUT,
+                )
+        else:
+            env = os.environ.copy()
+            env["__TRACE_OUT"] = trace
+            proc = subprocess.run(
+                [exe],
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+                env=env,
+                timeout=run._RUN_TIMEOUT,
+            )
+        if proc.returncode != 0:
+            raise RuntimeError(f"program exited with code {proc.returncode}")
+
+    stages["run"] = _measure(do_run)
+    if "error" in stages["run"]:
+        return stages
+
+    def do_normalize():
+        normalizer = StreamNormalizer()
+        folder = RunFolder()
+        count = 0
+        with open(trace, "rb") as f:
+            if is_python:
+                splitter = run._LineSplitter()
+                for chunk in iter(lambda: f.read(run._CHUNK_SIZE), b""):
+                    for line in splitter.feed(chunk):
+                        if normalizer.feed_line(line) is not None:
+                            count += 1
+                for line in splitter.finish():
+                    if normalizer.feed_line(line) is not None:
+                        count += 1
+            else:
+                decoder = binformat.Decoder()
+                for chunk in iter(lambda: f.read(run._CHUNK_SIZE), b""):
+                    for line in decoder.feed(chunk):
+                        trace_rec = normalizer.feed_line(line)
+                        if trace_rec is not None:
+                            count += len(folder.feed(trace_rec))
+                count += len(folder.flush())
+        if count == 0:
+            raise RuntimeError("no traces produced")
+
+    stages["normalize"] = _measure(do_normalize)
+    return stages
+
+
+def _best_of(src_path, workdir, repeats):
+    """Min wall time / max RSS per stage across repeats."""
+    best = {}
+    for _ in range(repeats):
+        stages = _bench_case(src_path, workdir)
+        for stage, res in stages.items():
+            if "error" in res:
+                return stages  # an error repeats; report it once
+            prev = best.get(stage)
+            if prev is None:
+                best[stage] = dict(res)
+            else:
+                prev["sec"] = min(prev["sec"], res["sec"])
+                prev["rss_kb"] = max(prev["rss_kb"], res["rss_kb"])
+    return best
+
+
+# ── Corpus ──────────────────────────────────────────────────────
+
+def _collect_cases(workdir, only=None):
+    """Yield (name, path) pairs: tests/ corpus plus synthetics."""
+    cases = []
+    if os.path.isdir(_TESTS_DIR):
+        for name in sorted(os.listdir(_TESTS_DIR)):
+            if name in _SKIP or os.path.splitext(name)[1] not in (".c", ".py"):
+                continue
+            cases.append((name, os.path.join(_TESTS_DIR, name)))
+    for name, gen in sorted(_SYNTHETIC.items()):
+        path = os.path.join(workdir, name)
+        with open(path, "w") as f:
+            f.write(gen())
+        cases.append((name, path))
+    if only:
+        cases = [(n, p) for n, p in cases if fnmatch.fnmatch(n, only)]
+    return cases
+
+
+# ── Baseline comparison ─────────────────────────────────────────
+
+def _compare(name, stage, res, base, threshold, rss_threshold):
+    """Return a regression message or None."""
+    if res["sec"] > base["sec"] * threshold and res["sec"] - base["sec"] > _SEC_FLOOR:
+        return (
+            f"{name}/{stage}: {res['sec']:.3f}s vs baseline "
+            f"{base['sec']:.3f}s (>{threshold:.2f}x)"
+        )
+    if base.get("rss_kb") and res["rss_kb"] > base["rss_kb"] * rss_threshold:
+        return (
+            f"{name}/{stage}: {res['rss_kb']} KB vs baseline "
+            f"{base['rss_kb']} KB (>{rss_threshold:.2f}x)"
+        )
+    return None
+
+
+def main():
+    ap = argparse.ArgumentParser(
+        description="Benchmark the trace pipeline per stage and gate on a baseline."
+    )
+    ap.add_argument("--baseline", default=_DEFAULT_BASELINE,
+                    help="Baseline JSON file (default: benchmark_baseline.json)")
+    ap.add_argument("--update-baseline", action="store_true",
+                    help="Record current numbers as the new baseline")
+    ap.add_argument("--threshold", type=float, default=1.30,
+                    help="Fail when stage wall time exceeds baseline by this factor")
+    ap.add_argument("--rss-threshold", type=float, default=1.50,
+                    help="Fail when stage peak RSS exceeds baseline by this factor")
+    ap.add_argument("--repeats", type=int, default=3,
+                    help="Repetitions per case (best wall time kept)")
+    ap.add_argument("--only", metavar="GLOB",
+                    help="Run only cases whose name matches this pattern")
+    args = ap.parse_args()
+
+    # Force the cold compile path: daemon availability must not change
+    # what the compile stage measures.
+    os.environ[compiler.SOCKET_ENV] = os.path.join(
+        tempfile.gettempdir(), "spiral-bench-no-daemon.sock"
+    )
+
+    results = {}
+    failures = []
+    with tempfile.TemporaryDirectory(prefix="spiral-bench-") as workdir:
+        cases = _collect_cases(workdir, args.only)
+        if not cases:
+            print("no benchmark cases matched", file=sys.stderr)
+            return 1
+
+        for name, path in cases:
+            case_dir = os.path.join(workdir, os.path.splitext(name)[0])
+            os.makedirs(case_dir, exist_ok=True)
+            stages = _best_of(path, case_dir, args.repeats)
+            results[name] = stages
+            for stage, res in stages.items():
+                if "error" in res:
+                    print(f"{name:34} {stage:10} ERROR  {res['error']}")
+                else:
+                    print(
+                        f"{name:34} {stage:10} "
+                        f"{res['sec'] * 1000:9.1f} ms  {res['rss_kb']:8d} KB"
+                    )
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(
+                {
+                    "recorded": datetime.now(timezone.utc).isoformat(),
+                    "repeats": args.repeats,
+                    "cases": results,
+                },
+                f,
+                indent=2,
+            )
+            f.write("\n")
+        print(f"\nbaseline written to {args.baseline}")
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print(
+            f"\nno baseline at {args.baseline} — run with --update-baseline first",
+            file=sys.stderr,
+        )
+        return 1
+
+    with open(args.baseline) as f:
+        baseline = json.load(f).get("cases", {})
+
+    for name, stages in results.items():
+        for stage, res in stages.items():
+            if "error" in res:
+                failures.append(f"{name}/{stage}: {res['error']}")
+                continue
+            base = baseline.get(name, {}).get(stage)
+            if base is None or "error" in base:
+                continue  # new case or previously broken stage: no gate yet
+            msg = _compare(name, stage, res, base,
+                           args.threshold, args.rss_threshold)
+            if msg:
+                failures.append(msg)
+
+    if failures:
+        print("\nregressions:", file=sys.stderr)
+        for msg in failures:
+            print(f"  {msg}", file=sys.stderr)
+        return 1
+
+    print("\nall stages within thresholds")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,239 @@
+"""Persistent compile daemon: amortizes gcc cost across requests.
+
+``run.py:_compile`` spawns a fresh ``gcc`` per upload, and most of that
+time goes to process startup plus recompiling the injected trace runtime
+(and the headers it drags in) from scratch for every request. Under a
+classroom burst of uploads the box spends more CPU in compiler startup
+than in user code.
+
+Two pieces live here:
+
+* ``CompileDaemon`` — a long-lived service on a Unix socket. At startup
+  it builds the trace runtime once into ``__trc_runtime.o``; each job
+  then swaps the inlined runtime block in the instrumented source for
+  extern declarations and links against the prebuilt object, so a job is
+  a single small-TU compile. A fixed pool of worker threads drains a
+  bounded queue — a burst queues instead of forking a gcc per request,
+  and overload is reported back as "busy" rather than absorbed.
+
+* ``compile_remote`` — the client side ``_compile`` calls: one JSON
+  request/response round-trip over the socket. Raises
+  ``DaemonUnavailable`` when the daemon is not running or its queue is
+  full, at which point the caller falls back to a cold gcc spawn, so the
+  daemon is a pure accelerator and never a single point of failure.
+
+Run it alongside the Flask server:
+
+    python compiler.py              # 4 workers, queue of 32
+    python compiler.py -j 8 -q 64
+"""
+
+import argparse
+import json
+import os
+import queue
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+
+from tracer.languages.c_runtime import (
+    RUNTIME_DECLS,
+    RUNTIME_SOURCE,
+    runtime_object_source,
+)
+
+# Socket the daemon listens on; override via the environment when running
+# several instances side by side (mirrors the __TRACE_OUT convention).
+SOCKET_ENV = "TRACE_COMPILE_SOCK"
+DEFAULT_SOCKET = os.path.join(tempfile.gettempdir(), "spiral-compile.sock")
+
+
+class DaemonUnavailable(Exception):
+    """The daemon is not running, unreachable, or its queue is full."""
+
+
+def _socket_path():
+    return os.environ.get(SOCKET_ENV, DEFAULT_SOCKET)
+
+
+def compile_remote(src_path, exe_path, gcc_args, timeout=10):
+    """Ask the daemon to compile ``src_path`` into ``exe_path``.
+
+    Raises ``DaemonUnavailable`` if no daemon answers (caller falls back
+    to a cold spawn) and ``RuntimeError`` with the compiler's stderr on an
+    actual compile failure, matching the cold path's error contract.
+    """
+    request = {
+        "src": os.path.abspath(src_path),
+        "exe": os.path.abspath(exe_path),
+        "args": list(gcc_args),
+        "timeout": timeout,
+    }
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    # Allow for queue wait on top of the compile itself.
+    sock.settimeout(timeout * 2 + 5)
+    try:
+        sock.connect(_socket_path())
+        sock.sendall(json.dumps(request).encode() + b"\n")
+        sock.shutdown(socket.SHUT_WR)
+        data = b""
+        while not data.endswith(b"\n"):
+            chunk = sock.recv(4096)
+            if not chunk:
+                break
+            data += chunk
+    except OSError as e:
+        raise DaemonUnavailable(str(e))
+    finally:
+        sock.close()
+
+    if not data:
+        raise DaemonUnavailable("empty response from compile daemon")
+    reply = json.loads(data)
+    if reply.get("busy"):
+        raise DaemonUnavailable("compile daemon queue is full")
+    if not reply.get("ok"):
+        raise RuntimeError(reply.get("error", "compilation failed"))
+    return exe_path
+
+
+class CompileDaemon:
+    """Warm compile service with a prebuilt trace-runtime object."""
+
+    def __init__(self, socket_path=None, jobs=4, queue_size=32):
+        self.socket_path = socket_path or _socket_path()
+        self.jobs = jobs
+        self._queue = queue.Queue(maxsize=queue_size)
+        self._workdir = tempfile.mkdtemp(prefix="trc-compile-")
+        self._runtime_obj = self._build_runtime_object()
+
+    def _build_runtime_object(self):
+        """Compile the trace runtime once; every job links against it."""
+        src = os.path.join(self._workdir, "__trc_runtime.c")
+        obj = os.path.join(self._workdir, "__trc_runtime.o")
+        with open(src, "w") as f:
+            f.write(runtime_object_source())
+        proc = subprocess.run(
+            ["gcc", "-c", src, "-o", obj], capture_output=True, text=True
+        )
+        if proc.returncode != 0:
+            raise RuntimeError(
+                f"trace runtime object build failed:\n{proc.stderr.strip()}"
+            )
+        return obj
+
+    def serve_forever(self):
+        if os.path.exists(self.socket_path):
+            os.unlink(self.socket_path)
+        server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        server.bind(self.socket_path)
+        server.listen(self._queue.maxsize)
+
+        for _ in range(self.jobs):
+            threading.Thread(target=self._worker, daemon=True).start()
+
+        print(
+            f"compile daemon on {self.socket_path} "
+            f"({self.jobs} workers, queue {self._queue.maxsize})"
+        )
+        while True:
+            conn, _ = server.accept()
+            try:
+                self._queue.put_nowait(conn)
+            except queue.Full:
+                # Push back instead of stalling: the client falls back to
+                # its own cold gcc, which is the pre-daemon behaviour.
+                self._reply(conn, {"busy": True})
+
+    def _worker(self):
+        while True:
+            conn = self._queue.get()
+            try:
+                request = self._read_request(conn)
+                self._run_job(request)
+                self._reply(conn, {"ok": True})
+            except (subprocess.TimeoutExpired, TimeoutError):
+                self._reply(conn, {"ok": False, "error": "Compilation timed out"})
+            except Exception as e:  # compile error, bad request, I/O
+                self._reply(conn, {"ok": False, "error": str(e)})
+
+    @staticmethod
+    def _read_request(conn):
+        data = b""
+        while not data.endswith(b"\n"):
+            chunk = conn.recv(4096)
+            if not chunk:
+                break
+            data += chunk
+        return json.loads(data)
+
+    @staticmethod
+    def _reply(conn, obj):
+        try:
+            conn.sendall(json.dumps(obj).encode() + b"\n")
+        except OSError:
+            pass
+        finally:
+            conn.close()
+
+    def _run_job(self, request):
+        src = request["src"]
+        exe = request["exe"]
+        args = request.get("args") or []
+        timeout = float(request.get("timeout", 10))
+
+        with open(src) as f:
+            code = f.read()
+
+        if RUNTIME_SOURCE in code:
+            # Swap the inlined runtime for declarations and link the
+            # prebuilt object. The #line directive keeps diagnostics
+            # pointing at the instrumented file with its original
+            # numbering, so compile errors read the same either way.
+            idx = code.find(RUNTIME_SOURCE)
+            next_line = code[: idx + len(RUNTIME_SOURCE)].count("\n") + 1
+            code = (
+                code[:idx]
+                + RUNTIME_DECLS
+                + f'#line {next_line} "{src}"\n'
+                + code[idx + len(RUNTIME_SOURCE):]
+            )
+            job_src = os.path.join(
+                self._workdir, f"job-{threading.get_ident()}.c"
+            )
+            with open(job_src, "w") as f:
+                f.write(code)
+            cmd = ["gcc", job_src, self._runtime_obj, "-o", exe] + args
+        else:
+            # Text/debug-mode sources carry no runtime block; plain build.
+            cmd = ["gcc", src, "-o", exe] + args
+
+        proc = subprocess.run(
+            cmd, capture_output=True, text=True, timeout=timeout
+        )
+        if proc.returncode != 0:
+            raise RuntimeError(proc.stderr.strip())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Persistent compile daemon")
+    parser.add_argument("-s", "--socket", default=None,
+                        help=f"Unix socket path (default: ${SOCKET_ENV} or {DEFAULT_SOCKET})")
+    parser.add_argument("-j", "--jobs", type=int, default=4,
+                        help="Worker threads (default: 4)")
+    parser.add_argument("-q", "--queue-size", type=int, default=32,
+                        help="Pending job limit before pushing back (default: 32)")
+    args = parser.parse_args()
+
+    daemon = CompileDaemon(args.socket, jobs=args.jobs, queue_size=args.queue_size)
+    try:
+        daemon.serve_forever()
+    except KeyboardInterrupt:
+        return 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,158 @@
+"""In-process job queue for asynchronous pipeline runs.
+
+Running instrument→compile→run→normalize inside the request handler ties
+a Flask worker up for the whole pipeline — a program that hits the run
+timeout holds one for tens of seconds, and a classroom of simultaneous
+uploads exhausts the pool. The queue decouples the two: submission
+returns a job id immediately, a small pool of worker threads drains the
+queue, and clients either poll the job's status or subscribe to a live
+event feed (the servers expose both).
+
+Worker threads, not processes: the expensive stages (gcc, the traced
+executable) are subprocesses anyway, so the GIL is released where it
+matters, and staying in-process keeps job state, progress events and the
+metrics registry in plain Python objects.
+
+Like the metrics registry, this lives in the serving process — import
+``QUEUE`` and share it; state is per-process and evaporates on restart.
+"""
+
+import os
+import queue
+import threading
+import time
+import uuid
+
+# Jobs retained for status queries after finishing; oldest finished jobs
+# are pruned past this many.
+MAX_JOBS = 200
+
+
+class JobQueue:
+    """Thread-pool job runner with per-job progress subscriptions."""
+
+    def __init__(self, workers=4):
+        self._lock = threading.Lock()
+        self._jobs: dict[str, dict] = {}
+        self._order: list[str] = []            # insertion order, for pruning
+        self._subscribers: dict[str, list] = {}  # job id → [queue.Queue, …]
+        self._pending: queue.Queue = queue.Queue()
+        self._workers = [
+            threading.Thread(target=self._worker, daemon=True)
+            for _ in range(workers)
+        ]
+        for t in self._workers:
+            t.start()
+
+    # ── submission / status ─────────────────────────────────────
+
+    def submit(self, func, label=""):
+        """Enqueue ``func(progress)`` and return its job id.
+
+        ``func`` runs on a worker thread; it gets a ``progress(stage)``
+        callback to report stage transitions and returns the result dict
+        stored on the finished job. An exception marks the job failed.
+        """
+        job_id = uuid.uuid4().hex[:12]
+        job = {
+            "id": job_id,
+            "label": label,
+            "state": "queued",
+            "stage": None,
+            "stages_done": [],
+            "created": time.time(),
+            "started": None,
+            "finished": None,
+            "result": None,
+            "error": None,
+        }
+        with self._lock:
+            self._jobs[job_id] = job
+            self._order.append(job_id)
+            self._prune_locked()
+        self._pending.put((job_id, func))
+        return job_id
+
+    def status(self, job_id):
+        """A snapshot of the job's public state, or None if unknown."""
+        with self._lock:
+            job = self._jobs.get(job_id)
+            return self._snapshot_locked(job) if job else None
+
+    def events(self, job_id):
+        """Yield status snapshots as the job progresses (generator).
+
+        The current state is yielded immediately, then one snapshot per
+        transition; the stream ends once the job is done or failed, so
+        an SSE route can iterate it directly.
+        """
+        sub = queue.Queue()
+        with self._lock:
+            job = self._jobs.get(job_id)
+            if job is None:
+                return
+            snapshot = self._snapshot_locked(job)
+            self._subscribers.setdefault(job_id, []).append(sub)
+        try:
+            yield snapshot
+            while snapshot["state"] not in ("done", "error"):
+                snapshot = sub.get()
+                yield snapshot
+        finally:
+            with self._lock:
+                subs = self._subscribers.get(job_id)
+                if subs and sub in subs:
+                    subs.remove(sub)
+                    if not subs:
+                        del self._subscribers[job_id]
+
+    # ── worker side ─────────────────────────────────────────────
+
+    def _worker(self):
+        while True:
+            job_id, func = self._pending.get()
+            self._update(job_id, state="running", started=time.time())
+
+            def on_progress(stage, job_id=job_id):
+                self._update(job_id, stage=stage)
+
+            try:
+                result = func(on_progress)
+                self._update(job_id, state="done", finished=time.time(),
+                             result=result, stage=None)
+            except Exception as e:
+                self._update(job_id, state="error", finished=time.time(),
+                             error=str(e), stage=None)
+
+    def _update(self, job_id, **fields):
+        with self._lock:
+            job = self._jobs.get(job_id)
+            if job is None:
+                return
+            # Any stage transition (including the final None) retires the
+            # stage that was running into stages_done.
+            if "stage" in fields and job["stage"] and job["stage"] not in job["stages_done"]:
+                job["stages_done"].append(job["stage"])
+            job.update(fields)
+            snapshot = self._snapshot_locked(job)
+            subs = list(self._subscribers.get(job_id, ()))
+        for sub in subs:
+            sub.put(snapshot)
+
+    @staticmethod
+    def _snapshot_locked(job):
+        snapshot = dict(job)
+        snapshot["stages_done"] = list(job["stages_done"])
+        return snapshot
+
+    def _prune_locked(self):
+        while len(self._order) > MAX_JOBS:
+            for i, old_id in enumerate(self._order):
+                if self._jobs[old_id]["state"] in ("done", "error"):
+                    del self._jobs[self._order.pop(i)]
+                    break
+            else:
+                break  # everything still queued/running — keep them all
+
+
+QUEUE = JobQueue(workers=int(os.environ.get("JOB_WORKERS", 4)))
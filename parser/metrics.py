@@ -0,0 +1,133 @@
+"""Process-local pipeline metrics with Prometheus text exposition.
+
+deal() fills a plain timings dict per request (no dependency on this
+module); the Flask layer feeds those dicts into the registry here and
+serves render() from /api/metrics. Keeping the registry in the server
+process means pool workers just return their timings dict alongside
+the result — nothing shared, nothing locked across processes.
+
+Exposed series:
+
+    pipeline_stage_seconds{stage=...}   per-stage latency histogram
+    pipeline_source_bytes               input source size
+    pipeline_trace_lines                normalized records per request
+    pipeline_output_bytes               emitted JSON size
+    pipeline_requests_total{status=...} ok / error counter
+"""
+
+import threading
+
+# Classic latency ladder — compile sits around 50-500ms cold, run and
+# normalize usually below that, so the low buckets carry the signal.
+_SECONDS_BUCKETS = (0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+                    0.25, 0.5, 1.0, 2.5, 5.0, 10.0)
+_BYTES_BUCKETS = (1024, 4096, 16384, 65536, 262144, 1048576,
+                  4194304, 16777216)
+_LINES_BUCKETS = (10, 100, 1000, 10000, 100000, 1000000)
+
+
+class Histogram:
+    """One Prometheus histogram series (optionally with a fixed label)."""
+
+    def __init__(self, buckets):
+        self.buckets = tuple(buckets)
+        self.counts = [0] * (len(self.buckets) + 1)  # last = +Inf
+        self.sum = 0.0
+        self.count = 0
+
+    def observe(self, value):
+        self.sum += value
+        self.count += 1
+        for i, bound in enumerate(self.buckets):
+            if value <= bound:
+                self.counts[i] += 1
+                return
+        self.counts[-1] += 1
+
+    def render(self, name, label=""):
+        lines = []
+        cumulative = 0
+        for i, bound in enumerate(self.buckets):
+            cumulative += self.counts[i]
+            lbl = _join(label, 'le="%s"' % _fmt(bound))
+            lines.append("%s_bucket{%s} %d" % (name, lbl, cumulative))
+        cumulative += self.counts[-1]
+        lines.append('%s_bucket{%s} %d'
+                     % (name, _join(label, 'le="+Inf"'), cumulative))
+        suffix = "{%s}" % label if label else ""
+        lines.append("%s_sum%s %s" % (name, suffix, _fmt(self.sum)))
+        lines.append("%s_count%s %d" % (name, suffix, self.count))
+        return lines
+
+
+def _fmt(value):
+    """Prometheus-friendly number: no trailing zeros, ints stay ints."""
+    if float(value) == int(value):
+        return str(int(value))
+    return repr(float(value))
+
+
+def _join(*parts):
+    return ",".join(p for p in parts if p)
+
+
+class PipelineMetrics:
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._stages = {}  # stage name -> Histogram
+        self._source_bytes = Histogram(_BYTES_BUCKETS)
+        self._trace_lines = Histogram(_LINES_BUCKETS)
+        self._output_bytes = Histogram(_BYTES_BUCKETS)
+        self._requests = {"ok": 0, "error": 0}
+
+    def observe(self, timings, success=True):
+        """Fold one request's timings dict (as filled by deal) in."""
+        if not timings:
+            return
+        with self._lock:
+            for stage, seconds in (timings.get("stages") or {}).items():
+                hist = self._stages.get(stage)
+                if hist is None:
+                    hist = self._stages[stage] = Histogram(_SECONDS_BUCKETS)
+                hist.observe(seconds)
+            if "source_bytes" in timings:
+                self._source_bytes.observe(timings["source_bytes"])
+            if "trace_lines" in timings:
+                self._trace_lines.observe(timings["trace_lines"])
+            if "output_bytes" in timings:
+                self._output_bytes.observe(timings["output_bytes"])
+            self._requests["ok" if success else "error"] += 1
+
+    def render(self):
+        """Prometheus text exposition format (0.0.4)."""
+        with self._lock:
+            out = [
+                "# HELP pipeline_stage_seconds Wall time per pipeline stage.",
+                "# TYPE pipeline_stage_seconds histogram",
+            ]
+            for stage in sorted(self._stages):
+                out.extend(self._stages[stage].render(
+                    "pipeline_stage_seconds", f'stage="{stage}"'))
+            for name, help_text, hist in (
+                ("pipeline_source_bytes", "Input source size in bytes.",
+                 self._source_bytes),
+                ("pipeline_trace_lines", "Normalized trace records per request.",
+                 self._trace_lines),
+                ("pipeline_output_bytes", "Emitted JSON size in bytes.",
+                 self._output_bytes),
+            ):
+                out.append(f"# HELP {name} {help_text}")
+                out.append(f"# TYPE {name} histogram")
+                out.extend(hist.render(name))
+            out.append("# HELP pipeline_requests_total Pipeline requests by outcome.")
+            out.append("# TYPE pipeline_requests_total counter")
+            for status in ("ok", "error"):
+                out.append(
+                    f'pipeline_requests_total{{status="{status}"}} '
+                    f"{self._requests[status]}"
+                )
+            return "\n".join(out) + "\n"
+
+
+# Shared registry for the serving process.
+REGISTRY = PipelineMetrics()
@@ -95,6 +95,21 @@ def create_type_LOOP(
     return result
 
 
+def create_type_LOOP_AGG(
+    subtype: str, condition: str, iterations: str, line_number: int, stack_depth: int
+) -> dict:
+    result = {
+        "type": "LOOP_AGG",
+        "subtype": subtype,
+        "iterations": int(iterations),
+        "line_number": line_number,
+        "stack_depth": stack_depth,
+    }
+    if condition:
+        result["condition"] = condition
+    return result
+
+
 def create_type_READ(
     subject: str, format_spec: str, address: str, line_number: int, stack_depth: int
 ) -> dict:
@@ -191,6 +206,17 @@ def create_type_TERNARY(
     }
 
 
+def create_type_ADDR(address: str, value: str, size: str) -> dict:
+    # Address-table entry from the binary runtime: `address` is the stable
+    # token records reference (a<id>), `value` the raw hex address.
+    return {
+        "type": "ADDR",
+        "address": address,
+        "value": value,
+        "size": int(size),
+    }
+
+
 def create_type_UNKNOWN(*args) -> dict:
     return {"type": "UNKNOWN", "args": args}
 
@@ -221,61 +247,379 @@ def generate_seed(meta_data: dict[str, str]) -> int:
     return result
 
 
-def stdin_to_json(stdin_data: str) -> dict[str, dict[str, str] | list[dict[str, any]]]:
-    lines = stdin_data.strip().split("\n")
-    metadata = {}
-    traces = []
-    trace_id = 0
-
-    switch: dict[str, Callable] = {
-        "ASSIGN": create_type_ASSIGN,
-        "BRANCH": create_type_BRANCH,
-        "CALL": create_type_CALL,
-        "CASE": create_type_CASE,
-        "CONDITION": create_type_CONDITION,
-        "DECL": create_type_DECL,
-        "EXTERNAL_CALL": create_type_EXTERNAL_CALL,
-        "LOOP": create_type_LOOP,
-        "PARAM": create_type_PARAM,
-        "READ": create_type_READ,
-        "RETURN": create_type_RETURN,
-        "SWITCH": create_type_SWITCH,
-        "TERNARY": create_type_TERNARY,
-        "UPDATE": create_type_UPDATE,
-    }
+TRACE_BUILDERS: dict[str, Callable] = {
+    "ADDR": create_type_ADDR,
+    "ASSIGN": create_type_ASSIGN,
+    "BRANCH": create_type_BRANCH,
+    "CALL": create_type_CALL,
+    "CASE": create_type_CASE,
+    "CONDITION": create_type_CONDITION,
+    "DECL": create_type_DECL,
+    "EXTERNAL_CALL": create_type_EXTERNAL_CALL,
+    "LOOP": create_type_LOOP,
+    "LOOP_AGG": create_type_LOOP_AGG,
+    "PARAM": create_type_PARAM,
+    "READ": create_type_READ,
+    "RETURN": create_type_RETURN,
+    "SWITCH": create_type_SWITCH,
+    "TERNARY": create_type_TERNARY,
+    "UPDATE": create_type_UPDATE,
+}
+
+
+# Trace fields that repeat heavily (names, conditions, addresses) and are
+# dictionary-coded in v2 output. Runtime values stay inline — they are
+# mostly unique, so interning them would only grow the table.
+INTERNED_FIELDS = ("subject", "subtype", "operator", "label", "condition", "address")
+
+
+class StringInterner:
+    """Builds the v2 string table: each distinct string gets a small index.
+
+    ``encode_trace`` rewrites a trace dict in place, replacing interned
+    fields with their table index; the accumulated ``strings`` list ships
+    once in the output instead of repeating per record.
+    """
+
+    def __init__(self):
+        self.strings: list[str] = []
+        self._index: dict[str, int] = {}
+
+    def intern(self, s: str) -> int:
+        idx = self._index.get(s)
+        if idx is None:
+            idx = len(self.strings)
+            self.strings.append(s)
+            self._index[s] = idx
+        return idx
+
+    def encode_trace(self, trace: dict) -> dict:
+        for field in INTERNED_FIELDS:
+            value = trace.get(field)
+            if isinstance(value, str):
+                trace[field] = self.intern(value)
+        return trace
+
+
+def _as_int(value) -> int:
+    try:
+        return int(value)
+    except (TypeError, ValueError):
+        return 0
+
+
+class CausalityIndex:
+    """Streaming def-use chain builder for the ``causality`` JSON section.
+
+    Tracks per-variable ordered writes and pairs READ records with the
+    write that consumes them, using the same rule the visualizer's
+    WorldState applies client-side: a pending read feeds a write when it
+    happened within two source lines or five events of it. Shipping the
+    index server-side lets the causality web draw precomputed edges
+    instead of rescanning the whole trace in the browser.
+    """
+
+    _WRITE_TYPES = ("ASSIGN", "DECL", "UPDATE")
+    _LINE_WINDOW = 2
+    _EVENT_WINDOW = 5
+    _MAX_PENDING = 80
+
+    def __init__(self):
+        self.variables: list[dict] = []   # [{"name": …, "address": …}]
+        self.writes: list[list[int]] = [] # parallel: ordered write event ids
+        self.links: list[dict] = []       # [{"from": vi, "to": vj, "step": id}]
+        self._var_index: dict[tuple, int] = {}
+        self._seen_links: set[tuple] = set()
+        self._pending_reads: list[tuple] = []  # (var idx, line, event id)
+
+    def _var(self, name, address) -> int:
+        key = (name, address)
+        idx = self._var_index.get(key)
+        if idx is None:
+            idx = len(self.variables)
+            self._var_index[key] = idx
+            self.variables.append({"name": name, "address": address})
+            self.writes.append([])
+        return idx
+
+    def feed(self, trace: dict) -> None:
+        trace_type = trace.get("type")
+
+        if trace_type == "READ":
+            idx = self._var(trace.get("subject", ""), trace.get("address", "0"))
+            self._pending_reads.append(
+                (idx, _as_int(trace.get("line_number")), trace["id"])
+            )
+            if len(self._pending_reads) > self._MAX_PENDING:
+                cutoff = trace["id"] - 2 * self._EVENT_WINDOW
+                self._pending_reads = [
+                    p for p in self._pending_reads if p[2] >= cutoff
+                ]
+            return
+
+        if trace_type not in self._WRITE_TYPES:
+            return
+
+        idx = self._var(trace.get("subject", ""), trace.get("address", "0"))
+        event_id = trace["id"]
+        line = _as_int(trace.get("line_number"))
+        self.writes[idx].append(event_id)
+
+        remaining = []
+        for read_idx, read_line, read_id in self._pending_reads:
+            if (abs(line - read_line) <= self._LINE_WINDOW
+                    or event_id - read_id <= self._EVENT_WINDOW):
+                if read_idx != idx:
+                    link_key = (read_idx, idx)
+                    if link_key not in self._seen_links:
+                        self._seen_links.add(link_key)
+                        self.links.append(
+                            {"from": read_idx, "to": idx, "step": event_id}
+                        )
+            else:
+                remaining.append((read_idx, read_line, read_id))
+        self._pending_reads = remaining
+
+    def to_json(self) -> dict | None:
+        if not self.variables:
+            return None
+        return {
+            "variables": self.variables,
+            "writes": self.writes,
+            "links": self.links,
+        }
+
+
+class CallTreeIndex:
+    """Streaming scope tracker — stamps call-tree nesting onto the records.
+
+    The browser used to reconstruct the call hierarchy three times per
+    load — WorldState while ingesting, then the tree and sub-spiral
+    renderers again from the flat array. The normalizer sees the same
+    CALL/RETURN/LOOP/CONDITION boundaries first, so it resolves the
+    nesting once and writes it into the records themselves: every
+    function invocation, loop run and branch gets a node id, each record
+    carries the id of its innermost enclosing scope (``scope``) and each
+    scope-opening record additionally the id of the node it opens
+    (``node``). The stamps travel with the records, so a windowed slice
+    needs no side table — WorldState attributes steps to containers
+    straight off the stamped chain and the branch renderer tells direct
+    children from nested ones by comparing ids.
+
+    Scope semantics match WorldState's container stack: an opening record
+    (CALL, first truthy LOOP, CONDITION) belongs to its *parent* scope and
+    the new scope starts at the following record; the closing record
+    (RETURN, falsy LOOP, BRANCH) still belongs to the scope it closes.
+    """
+
+    def __init__(self):
+        self._types: list[str] = []   # node id == list index
+        self._stack: list[int] = []   # open node ids, outermost first
+        self._running_loops: dict[tuple, int] = {}  # lookup key → node id
+
+    def _open(self, node_type, trace) -> int:
+        node_id = len(self._types)
+        self._types.append(node_type)
+        trace["node"] = node_id
+        self._stack.append(node_id)
+        return node_id
+
+    def _close(self, node_id) -> None:
+        # Splice just this node out, the way WorldState does — scopes it
+        # still contains keep their parent and close on their own records.
+        if node_id in self._stack:
+            self._stack.remove(node_id)
+
+    def _function_scope(self) -> int:
+        """Innermost open *function* — loop identity keys off it, like
+        WorldState's ``currentScope()``, so iterations of one loop run
+        keep matching no matter how deep the loop scope itself nests."""
+        for node_id in reversed(self._stack):
+            if self._types[node_id] == "function":
+                return node_id
+        return -1
+
+    def feed(self, trace: dict) -> None:
+        """Stamp the record's scope, then apply its open/close effect."""
+        trace["scope"] = self._stack[-1] if self._stack else -1
+        trace_type = trace.get("type")
+
+        if trace_type == "CALL":
+            self._open("function", trace)
+
+        elif trace_type == "EXTERNAL_CALL":
+            # Instantaneous — a leaf node, never pushed as a scope.
+            node_id = self._open("external", trace)
+            self._close(node_id)
+
+        elif trace_type == "RETURN":
+            for node_id in reversed(self._stack):
+                if self._types[node_id] == "function":
+                    self._close(node_id)
+                    break
+
+        elif trace_type == "LOOP":
+            key = (self._function_scope(), _as_int(trace.get("line_number")),
+                   trace.get("condition"), trace.get("subtype"))
+            running = self._running_loops.get(key)
+            if _as_int(trace.get("condition_result")):
+                if running is None:
+                    # First iteration → new loop scope.
+                    self._running_loops[key] = self._open("loop", trace)
+                # else: continuing iteration of the open loop run.
+            elif running is not None:
+                self._close(running)
+                del self._running_loops[key]
+
+        elif trace_type == "CONDITION":
+            self._open("branch", trace)
+
+        elif trace_type == "BRANCH":
+            for node_id in reversed(self._stack):
+                if self._types[node_id] == "branch":
+                    self._close(node_id)
+                    break
+
+
+class RunFolder:
+    """Folds runs of structurally identical records into one RUN record.
+
+    Hot loops produce long stretches of records that differ only in their
+    values. Consecutive foldable records sharing (type, subject,
+    line_number, stack_depth) collapse into::
+
+        {"type": "RUN", "of": <original type>, <template fields…>,
+         "count": n, "deltas": [{changed fields per record}, …]}
+
+    The template is the first record of the run (keeping its id); each
+    delta holds only the fields that differ from it, so a tight counter
+    loop costs a few bytes per iteration instead of a whole record. Runs
+    shorter than ``min_run`` pass through untouched, as does every
+    non-foldable type — CALL/RETURN must stay individual records for the
+    call-stack logic downstream.
+    """
+
+    FOLDABLE = ("ASSIGN", "READ", "UPDATE", "LOOP")
+    _KEY_FIELDS = ("type", "subject", "line_number", "stack_depth")
+
+    def __init__(self, min_run: int = 4):
+        self.min_run = min_run
+        self._key = None
+        self._buffer: list[dict] = []
+
+    def feed(self, trace: dict) -> list[dict]:
+        """Feed one record; returns the records ready to emit (often none)."""
+        key = None
+        if trace.get("type") in self.FOLDABLE:
+            key = tuple(trace.get(f) for f in self._KEY_FIELDS)
+
+        if key is not None and key == self._key:
+            self._buffer.append(trace)
+            return []
+
+        out = self._drain()
+        self._key = key
+        self._buffer = [trace] if key is not None else []
+        if key is None:
+            out.append(trace)
+        return out
+
+    def flush(self) -> list[dict]:
+        """Emit whatever is still buffered (end of stream)."""
+        out = self._drain()
+        self._key = None
+        self._buffer = []
+        return out
+
+    def _drain(self) -> list[dict]:
+        if len(self._buffer) < self.min_run:
+            return list(self._buffer)
+
+        template = dict(self._buffer[0])
+        deltas = []
+        for trace in self._buffer:
+            deltas.append({
+                k: v for k, v in trace.items()
+                if k != "id" and template.get(k) != v
+            })
+
+        run = dict(template)
+        run["type"] = "RUN"
+        run["of"] = template["type"]
+        run["count"] = len(self._buffer)
+        run["deltas"] = deltas
+        return [run]
+
+
+class StreamNormalizer:
+    """Incremental normalizer: feed trace lines as they arrive.
+
+    Holds only the metadata dict and a running trace ID, so memory stays
+    bounded no matter how long the trace is. ``feed_line`` returns the
+    normalized trace dict for the line (or ``None`` for META/blank lines);
+    the caller decides where it goes — an in-memory list, a file, …
+    Every returned trace also feeds the ``causality`` and ``call_tree``
+    indexes; the latter stamps ``scope``/``node`` fields onto the trace.
+    """
+
+    def __init__(self):
+        self.metadata: dict[str, str] = {}
+        self.causality = CausalityIndex()
+        self.call_tree = CallTreeIndex()
+        self._trace_id = 0
+
+    def feed_line(self, line: str) -> dict | None:
+        if not line:
+            return None
 
-    for line in lines:
         # Split by null character to get fields
         fields = line.split("\0")
-
         trace_type = fields[0]
 
         if trace_type == "META":
             # Metadata goes into the metadata section
             if len(fields) >= 3:
-                metadata[fields[1]] = fields[2]
-        elif trace_type in switch:
-            # All other types go into traces array
+                self.metadata[fields[1]] = fields[2]
+            return None
+
+        if trace_type in TRACE_BUILDERS:
             try:
-                trace_obj = switch[trace_type](*fields[1:])
-                trace_obj["id"] = trace_id
-                traces.append(trace_obj)
-                trace_id += 1
+                trace_obj = TRACE_BUILDERS[trace_type](*fields[1:])
             except Exception as e:
                 print(f"Error: Error processing line: {line}")
                 print(f"Error: Exception: {e}")
+                return None
         else:
             print(f"Error: Unknown type: {trace_type} in line: {line}")
             try:
                 trace_obj = create_type_UNKNOWN(*fields)
-                trace_obj["id"] = trace_id
-                traces.append(trace_obj)
-                trace_id += 1
             except Exception as e:
                 print(f"Error: Error processing unknown type: {e}")
+                return None
+
+        trace_obj["id"] = self._trace_id
+        self._trace_id += 1
+        self.causality.feed(trace_obj)
+        self.call_tree.feed(trace_obj)
+        return trace_obj
+
+
+def stdin_to_json(stdin_data: str) -> dict[str, dict[str, str] | list[dict[str, any]]]:
+    normalizer = StreamNormalizer()
+    folder = RunFolder()
+    traces = []
+    for line in stdin_data.strip().split("\n"):
+        trace_obj = normalizer.feed_line(line)
+        if trace_obj is not None:
+            traces.extend(folder.feed(trace_obj))
+    traces.extend(folder.flush())
 
     # Return structure with metadata and traces
-    result = {"metadata": metadata, "traces": traces}
+    result = {"metadata": normalizer.metadata, "traces": traces}
+
+    causality = normalizer.causality.to_json()
+    if causality is not None:
+        result["causality"] = causality
 
     return result
 
@@ -6,17 +6,39 @@ Usage:
 """
 
 import argparse
+import hashlib
 import json
 import os
+import shutil
 import subprocess
 import sys
+import tempfile
+import threading
+import time
 
 from tree_sitter import Parser
 
-from normalize import fill_json, stdin_to_json
+from compiler import DaemonUnavailable, compile_remote
+from normalize import (
+    RunFolder,
+    StreamNormalizer,
+    StringInterner,
+    fill_json,
+    generate_seed,
+    stdin_to_json,
+)
+import tracediff
+import tracestore
+from tracer import INSTRUMENTER_VERSION, binformat
 from tracer import languages as _languages  # noqa: F401
 from tracer.registry import get_language
 
+# Chunk size for streaming reads of the child's stdout / the trace sink.
+_CHUNK_SIZE = 1 << 16
+
+# Wall-clock budget for the traced program itself.
+_RUN_TIMEOUT = 10
+
 
 def _make_error(stage, message, metadata=None, traces=None):
     return {
@@ -40,12 +62,13 @@ def _derived_paths(input_file):
     return {
         "instrumented": os.path.join(output_directory, f"instrumented_{base_name}{ext}"),
         "trace": os.path.join(output_directory, f"{base_name}_trace.txt"),
+        "trace_store": os.path.join(output_directory, f"{base_name}_trace.trcs"),
         "exe": os.path.join(output_directory, f"{base_name}.exe"),
         "ext": ext,
     }
 
 
-def _instrument(input_file):
+def _instrument(input_file, trace_format="binary"):
     ext = os.path.splitext(input_file)[1]
     lang = get_language(ext)
     if not lang:
@@ -57,15 +80,50 @@ def _instrument(input_file):
     ts_parser = Parser()
     ts_parser.language = lang.get_ts_language()
 
-    symbol_table = lang.analyze_types(ts_parser, code_bytes)
-    metadata = lang.collect_metadata(ts_parser, code_bytes, input_file)
-    code = lang.instrument(ts_parser, code_bytes, symbol_table, metadata)
+    # Parse once; all three stages walk the same tree
+    tree = ts_parser.parse(code_bytes)
+    symbol_table = lang.analyze_types(ts_parser, code_bytes, tree=tree)
+    metadata = lang.collect_metadata(ts_parser, code_bytes, input_file, tree=tree)
+    code = lang.instrument(
+        ts_parser, code_bytes, symbol_table, metadata, trace_format, tree=tree
+    )
     return code, ext
 
 
+def _collect_metadata(input_file):
+    """Metadata only — used when the monitoring engine skips _instrument."""
+    ext = os.path.splitext(input_file)[1]
+    lang = get_language(ext)
+    if not lang:
+        raise ValueError(f"Unsupported extension '{ext}'")
+
+    with open(input_file, "rb") as f:
+        code_bytes = f.read()
+
+    ts_parser = Parser()
+    ts_parser.language = lang.get_ts_language()
+    return lang.collect_metadata(ts_parser, code_bytes, input_file)
+
+
+# Extra gcc arguments — part of the cache key, so changing them invalidates
+# previously built executables.
+_GCC_ARGS = ["-lm"]
+
+
 def _compile(src_path, exe_path):
+    """Compile via the warm daemon when one is running; cold gcc otherwise.
+
+    The daemon (compiler.py) links instrumented sources against a prebuilt
+    trace-runtime object, skipping the per-request runtime recompile. It is
+    strictly optional: any failure to reach it falls through to the plain
+    spawn below, which stays the behaviour of record.
+    """
+    try:
+        return compile_remote(src_path, exe_path, _GCC_ARGS, timeout=10)
+    except DaemonUnavailable:
+        pass
     proc = subprocess.run(
-        ["gcc", src_path, "-o", exe_path, "-lm"],
+        ["gcc", src_path, "-o", exe_path] + _GCC_ARGS,
         capture_output=True,
         text=True,
         timeout=10,
@@ -75,11 +133,174 @@ def _compile(src_path, exe_path):
     return exe_path
 
 
-def _run(cmd, timeout=10):
-    proc = subprocess.run(cmd, capture_output=True, timeout=timeout)
-    stdout = proc.stdout.decode("utf-8", errors="replace").replace("\r\n", "\n")
-    stderr = proc.stderr.decode("utf-8", errors="replace").strip()
-    return proc.returncode, stdout, stderr
+def _cache_key(src_bytes: bytes, trace_format: str) -> str:
+    """Content hash keying the instrumented-source/executable cache."""
+    h = hashlib.sha256()
+    h.update(src_bytes)
+    h.update(INSTRUMENTER_VERSION.encode())
+    h.update(trace_format.encode())
+    h.update(" ".join(_GCC_ARGS).encode())
+    return h.hexdigest()[:16]
+
+
+def _run_streaming(cmd, sink, timeout=10, env=None):
+    """Run ``cmd``, feeding stdout chunks to ``sink`` as they arrive.
+
+    Unlike ``_run`` this never buffers the whole stream: each chunk goes
+    straight to the caller. stderr is spooled to a temp file so a chatty
+    child cannot deadlock on a full pipe.
+
+    A timed-out child gets SIGTERM first — the trace runtime flushes its
+    record buffer on it — then a hard kill shortly after. Rather than
+    raising, the timeout is reported in the return value so the caller
+    can keep everything captured up to the kill.
+
+    Returns ``(returncode, stderr, timed_out)``.
+    """
+    timed_out = {"value": False}
+    with tempfile.TemporaryFile() as err_f:
+        proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=err_f, env=env)
+
+        def _kill():
+            timed_out["value"] = True
+            proc.terminate()
+            threading.Timer(1.0, proc.kill).start()
+
+        timer = threading.Timer(timeout, _kill)
+        timer.start()
+        try:
+            for chunk in iter(lambda: proc.stdout.read(_CHUNK_SIZE), b""):
+                sink(chunk)
+            proc.wait()
+        finally:
+            timer.cancel()
+            proc.stdout.close()
+        err_f.seek(0)
+        stderr = err_f.read().decode("utf-8", errors="replace").strip()
+    return proc.returncode, stderr, timed_out["value"]
+
+
+class _RingCapture:
+    """Size-capped capture of a byte stream: head plus most recent tail.
+
+    Keeps the first ``head_cap`` bytes and a rolling window of the last
+    ``tail_cap`` bytes, dropping the middle. A runaway program can print
+    forever without growing pipeline memory, and what survives — how the
+    stream started plus what came right before the kill — is exactly what
+    is useful after a timeout.
+    """
+
+    def __init__(self, head_cap=1 << 20, tail_cap=1 << 20):
+        self.head_cap = head_cap
+        self.tail_cap = tail_cap
+        self._head = bytearray()
+        self._tail = bytearray()
+        self.dropped = 0
+
+    def feed(self, chunk):
+        room = self.head_cap - len(self._head)
+        if room > 0:
+            self._head += chunk[:room]
+            chunk = chunk[room:]
+        if chunk:
+            self._tail += chunk
+            excess = len(self._tail) - self.tail_cap
+            if excess > 0:
+                del self._tail[:excess]
+                self.dropped += excess
+
+    def bytes(self):
+        return bytes(self._head) + bytes(self._tail)
+
+
+class _LineSplitter:
+    """Incremental splitter for text-mode traces arriving in chunks."""
+
+    def __init__(self):
+        self._tail = b""
+
+    def feed(self, chunk: bytes) -> list[str]:
+        data = self._tail + chunk
+        *complete, self._tail = data.split(b"\n")
+        return [
+            line.decode("utf-8", errors="replace").rstrip("\r")
+            for line in complete
+        ]
+
+    def finish(self) -> list[str]:
+        tail, self._tail = self._tail, b""
+        if not tail:
+            return []
+        return [tail.decode("utf-8", errors="replace").rstrip("\r")]
+
+
+class _StreamEmitter:
+    """Writes the result JSON incrementally.
+
+    Traces spill to the output as they are normalized; metadata, seed and
+    the success flag close the object once the run's outcome is known —
+    JSON key order is free, so the header fields can come last.
+    """
+
+    def __init__(self, output_path, compact=True):
+        self.output_path = output_path
+        self._f = None
+        self._count = 0
+        # v2 output dictionary-codes repeated strings (names, conditions,
+        # addresses) into a table written once at close.
+        self._interner = StringInterner() if compact else None
+
+    def begin(self):
+        if self.output_path:
+            output_dir = os.path.dirname(self.output_path)
+            if output_dir:
+                os.makedirs(output_dir, exist_ok=True)
+            self._f = open(self.output_path, "w")
+        else:
+            self._f = sys.stdout
+        if self._interner:
+            self._f.write('{\n  "version": 2,\n  "traces": [\n')
+        else:
+            self._f.write('{\n  "traces": [\n')
+
+    def trace(self, trace_obj):
+        if self._interner:
+            trace_obj = self._interner.encode_trace(trace_obj)
+        if self._count:
+            self._f.write(",\n")
+        self._f.write("    " + json.dumps(trace_obj))
+        self._count += 1
+
+    def close(self, metadata, seed=None, success=True, error=None, causality=None):
+        self._f.write("\n  ],\n" if self._count else "  ],\n")
+        if self._interner:
+            self._f.write('  "strings": ' + json.dumps(self._interner.strings) + ",\n")
+        if causality is not None:
+            self._f.write('  "causality": ' + json.dumps(causality) + ",\n")
+        self._f.write('  "metadata": ' + json.dumps(metadata))
+        if success:
+            if seed == -1 or seed is None:
+                seed = generate_seed(metadata)
+            self._f.write(',\n  "seed": ' + json.dumps(seed))
+            self._f.write(',\n  "success": true\n}\n')
+        else:
+            self._f.write(',\n  "success": false')
+            self._f.write(',\n  "error": ' + json.dumps(error) + "\n}\n")
+        if self.output_path:
+            self._f.close()
+
+    def abort(self):
+        """Drop the partial output so _emit can rewrite the file whole."""
+        if self._f and self.output_path:
+            self._f.close()
+        self._f = None
+
+
+def _decode_trace(raw_output: bytes) -> str:
+    """Turn raw trace output (binary records or text) into trace lines."""
+    if binformat.is_binary_trace(raw_output):
+        return "\n".join(binformat.decode_bytes(raw_output))
+    return raw_output.decode("utf-8", errors="replace").replace("\r\n", "\n")
 
 
 def _normalize(raw_output, seed):
@@ -89,93 +310,356 @@ def _normalize(raw_output, seed):
     return result.get("metadata", {}), result.get("traces", []), result.get("seed", -1)
 
 
-def deal(input, output=None, seed=None):
-    paths = _derived_paths(input)
-    
-    # If output path is specified, ensure it goes in the output folder
+def _resolve_output(input, output):
+    """The effective output JSON path: explicit paths land in the input's
+    output/ folder unless absolute; no path means a default name there."""
+    input_dir = os.path.dirname(os.path.abspath(input))
+    output_dir = os.path.join(input_dir, "output")
     if output:
-        # If it's just a filename or relative path, put it in output folder
         if not os.path.isabs(output):
-            input_dir = os.path.dirname(os.path.abspath(input))
-            output_dir = os.path.join(input_dir, "output")
             output = os.path.join(output_dir, os.path.basename(output))
-    else:
-        # If no output specified, create default JSON name based on input file
-        basename = os.path.basename(input)
-        stem, ext = os.path.splitext(basename)
-        ext_no_dot = ext.lstrip('.')
-        input_dir = os.path.dirname(os.path.abspath(input))
-        output_dir = os.path.join(input_dir, "output")
-        output = os.path.join(output_dir, f"{stem}_{ext_no_dot}.json")
+        return output
+    stem, ext = os.path.splitext(os.path.basename(input))
+    return os.path.join(output_dir, f"{stem}_{ext.lstrip('.')}.json")
 
-    # ── Instrument ──────────────────────────────────────────────
+
+def _notify(progress, stage):
+    """Report a stage start to an interested caller (the job queue). A
+    broken callback must never take the pipeline down with it."""
+    if progress is None:
+        return
     try:
-        code, ext = _instrument(input)
-    except Exception as e:
-        result = _make_error("instrument", str(e))
-        _emit(result, output)
-        return 1
+        progress(stage)
+    except Exception:
+        pass
 
-    with open(paths["instrumented"], "w") as f:
-        f.write(code)
 
-    # ── Compile / Run ───────────────────────────────────────────
-    is_python = ext == ".py"
+def deal(input, output=None, seed=None, trace_format="binary",
+         py_engine="instrument", timings=None, progress=None):
+    paths = _derived_paths(input)
 
-    if is_python:
-        cmd = [sys.executable, paths["instrumented"]]
-    else:
-        try:
-            _compile(paths["instrumented"], paths["exe"])
-        except subprocess.TimeoutExpired:
-            result = _make_error("compile", "Compilation timed out")
+    # Per-stage timing for the server's metrics endpoint: callers pass a
+    # dict and read stage durations and sizes back out after the call.
+    # Kept as plain floats so pool workers can ship it across processes.
+    # ``progress``, when given, is called with each stage name as the
+    # stage begins — the async job queue streams these to the client.
+    t_stages = {}
+    if timings is not None:
+        timings["stages"] = t_stages
+
+    output = _resolve_output(input, output)
+
+    # ── Python engine selection ─────────────────────────────────
+    # "monitoring" runs the script unmodified under the sys.monitoring
+    # tracer (tracer/monitor.py, CPython 3.12+) — no instrumented copy,
+    # no cache artifacts. "auto" takes it when the interpreter has it.
+    ext = os.path.splitext(input)[1]
+    use_monitoring = ext == ".py" and py_engine != "instrument"
+    if use_monitoring and not hasattr(sys, "monitoring"):
+        if py_engine == "monitoring":
+            result = _make_error(
+                "instrument",
+                "py-engine 'monitoring' requires CPython 3.12+ (sys.monitoring)",
+            )
             _emit(result, output)
             return 1
-        except RuntimeError as e:
-            result = _make_error("compile", str(e))
+        use_monitoring = False  # auto: fall back to the instrumenter
+
+    # ── Cache lookup ────────────────────────────────────────────
+    # Keyed on (source content, instrumenter version, gcc flags): a
+    # re-upload of an unchanged file skips instrument and compile and
+    # goes straight to run + normalize.
+    with open(input, "rb") as f:
+        src_bytes = f.read()
+    if timings is not None:
+        timings["source_bytes"] = len(src_bytes)
+    key = _cache_key(src_bytes, trace_format)
+    cache_dir = os.path.join(os.path.dirname(paths["instrumented"]), ".cache")
+    cached_src = os.path.join(cache_dir, f"{key}{ext}")
+    cached_exe = os.path.join(cache_dir, f"{key}.exe")
+
+    # ── Instrument ──────────────────────────────────────────────
+    _notify(progress, "instrument")
+    t0 = time.monotonic()
+    if use_monitoring:
+        pass  # the monitoring engine traces the original source
+    elif os.path.exists(cached_src):
+        shutil.copyfile(cached_src, paths["instrumented"])
+    else:
+        try:
+            code, ext = _instrument(input, trace_format)
+        except Exception as e:
+            result = _make_error("instrument", str(e))
             _emit(result, output)
             return 1
-        cmd = [paths["exe"]]
 
-    try:
-        rc, stdout, stderr = _run(cmd)
-    except subprocess.TimeoutExpired:
-        result = _make_error("runtime", "Program timed out (30s limit)")
-        _emit(result, output)
-        return 1
+        with open(paths["instrumented"], "w") as f:
+            f.write(code)
+        os.makedirs(cache_dir, exist_ok=True)
+        shutil.copyfile(paths["instrumented"], cached_src)
+    t_stages["instrument"] = time.monotonic() - t0
 
-    # Save raw trace output
-    with open(paths["trace"], "w") as f:
-        f.write(stdout)
+    # ── Compile / Run ───────────────────────────────────────────
+    is_python = ext == ".py"
+
+    if is_python:
+        if use_monitoring:
+            monitor_path = os.path.join(
+                os.path.dirname(os.path.abspath(__file__)), "tracer", "monitor.py"
+            )
+            cmd = [sys.executable, monitor_path, os.path.abspath(input)]
+        else:
+            cmd = [sys.executable, paths["instrumented"]]
+    else:
+        _notify(progress, "compile")
+        t0 = time.monotonic()
+        if os.path.exists(cached_exe):
+            shutil.copy(cached_exe, paths["exe"])
+        else:
+            try:
+                _compile(paths["instrumented"], paths["exe"])
+            except subprocess.TimeoutExpired:
+                result = _make_error("compile", "Compilation timed out")
+                _emit(result, output)
+                return 1
+            except RuntimeError as e:
+                result = _make_error("compile", str(e))
+                _emit(result, output)
+                return 1
+            shutil.copy(paths["exe"], cached_exe)
+        t_stages["compile"] = time.monotonic() - t0
+        cmd = [paths["exe"]]
+
+    # The binary runtime writes records to its own sink (a dedicated file,
+    # flushed by signal/atexit handlers on crash) so the program's stdout
+    # stays untouched. Text/debug mode still traces over stdout.
+    use_trace_file = not is_python and trace_format == "binary"
+    env = None
+    if use_trace_file:
+        env = os.environ.copy()
+        env["__TRACE_OUT"] = paths["trace"]
+        if os.path.exists(paths["trace"]):
+            os.remove(paths["trace"])
+
+    # ── Run / Normalize (streaming) ─────────────────────────────
+    # Traces flow chunk → decoder → normalizer → output file as they
+    # arrive, so pipeline memory stays bounded regardless of trace length.
+    # A runtime error still leaves the partial trace in the output — it
+    # feeds the error marker in the visualizer.
+    normalizer = StreamNormalizer()
+    folder = RunFolder()
+    emitter = _StreamEmitter(output)
+    store = None
+
+    # The monitoring engine never sees the instrumenter, so the META
+    # records it would have injected are collected here instead.
+    if use_monitoring:
+        try:
+            normalizer.metadata.update(
+                {k: str(v) for k, v in _collect_metadata(input).items()}
+            )
+        except Exception:
+            normalizer.metadata.setdefault("file_name", os.path.basename(input))
+            normalizer.metadata.setdefault("language", "python")
 
-    # ── Normalize ───────────────────────────────────────────────
-    # ── Normalize ───────────────────────────────────────────────
-    # Always try to normalize stdout, even if there was a runtime error
     try:
-        metadata, traces, seed = _normalize(stdout, seed)
+        if use_trace_file:
+            # The sink file fills while the program runs; decode it in
+            # chunks afterwards instead of reading it whole. The program's
+            # own stdout goes into a capped ring so a runaway printf loop
+            # cannot grow pipeline memory.
+            stdout_ring = _RingCapture()
+            _notify(progress, "run")
+            t0 = time.monotonic()
+            rc, stderr, timed_out = _run_streaming(
+                cmd, stdout_ring.feed, timeout=_RUN_TIMEOUT, env=env
+            )
+            t_stages["run"] = time.monotonic() - t0
+            emitter.begin()
+            _notify(progress, "normalize")
+            t0 = time.monotonic()
+            # The normalize pass doubles as conversion into the indexed
+            # store: every folded record is teed (before interning, so
+            # strings stay resolved) into compressed record blocks and
+            # the flat sink is deleted — retained traces stay windowable
+            # without re-parsing the whole result JSON.
+            decoder = binformat.Decoder()
+            store = tracestore.TraceStoreWriter(paths["trace_store"])
+            if os.path.exists(paths["trace"]):
+                with open(paths["trace"], "rb") as f:
+                    for chunk in iter(lambda: f.read(_CHUNK_SIZE), b""):
+                        for line in decoder.feed(chunk):
+                            trace = normalizer.feed_line(line)
+                            if trace is not None:
+                                for out in folder.feed(trace):
+                                    store.append(out)
+                                    emitter.trace(out)
+            if os.path.exists(paths["trace"]):
+                os.remove(paths["trace"])
+            t_stages["normalize"] = time.monotonic() - t0
+        else:
+            # Text traces arrive on the child's stdout: normalize them as
+            # they are produced and mirror the raw bytes to the trace file.
+            # Normalization is inlined in the stdout sink here, so its
+            # time lands in the run stage for text traces.
+            emitter.begin()
+            _notify(progress, "run")
+            t0 = time.monotonic()
+            splitter = _LineSplitter()
+            with open(paths["trace"], "wb") as trace_file:
+
+                def sink(chunk):
+                    trace_file.write(chunk)
+                    for line in splitter.feed(chunk):
+                        trace = normalizer.feed_line(line)
+                        if trace is not None:
+                            for out in folder.feed(trace):
+                                emitter.trace(out)
+
+                rc, stderr, timed_out = _run_streaming(
+                    cmd, sink, timeout=_RUN_TIMEOUT, env=env
+                )
+            for line in splitter.finish():
+                trace = normalizer.feed_line(line)
+                if trace is not None:
+                    for out in folder.feed(trace):
+                        emitter.trace(out)
+            t_stages["run"] = time.monotonic() - t0
     except Exception as e:
-        # If normalization fails, we can't do much with the traces
+        emitter.abort()
+        if store is not None:
+            store.abort()
         result = _make_error("normalize", f"Failed to parse trace output: {e}")
         _emit(result, output)
         return 1
 
+    for out in folder.flush():
+        if store is not None:
+            store.append(out)
+        emitter.trace(out)
+
+    _notify(progress, "emit")
+
+    def _record_emit(started):
+        t_stages["emit"] = time.monotonic() - started
+        if timings is not None:
+            timings["trace_lines"] = emitter._count
+            if output and os.path.exists(output):
+                timings["output_bytes"] = os.path.getsize(output)
+
+    if timed_out:
+        # Keep everything normalized so far and close the JSON as a
+        # partial trace — students still get the spiral up to the hang
+        # instead of a blank screen.
+        t0 = time.monotonic()
+        error = {
+            "stage": "runtime",
+            "message": f"Program timed out ({_RUN_TIMEOUT}s limit); "
+                       "showing the trace captured before it was stopped",
+            "partial": True,
+        }
+        emitter.close(
+            normalizer.metadata,
+            success=False,
+            error=error,
+            causality=normalizer.causality.to_json(),
+        )
+        if store is not None:
+            store.close(metadata=normalizer.metadata, success=False, error=error)
+        _record_emit(t0)
+        return 1
+
     if stderr or rc != 0:
         # Runtime error occurred, but we might have partial traces
         msg = stderr if stderr else f"Program exited with code {rc}"
-        result = _make_error(
-            "runtime",
-            msg,
-            metadata=metadata,
-            traces=traces,
+        t0 = time.monotonic()
+        error = {"stage": "runtime", "message": msg}
+        emitter.close(
+            normalizer.metadata,
+            success=False,
+            error=error,
+            causality=normalizer.causality.to_json(),
         )
-        _emit(result, output)
+        if store is not None:
+            store.close(metadata=normalizer.metadata, success=False, error=error)
+        _record_emit(t0)
         return 1
 
-    result = {"success": True, "metadata": metadata, "traces": traces, "seed": seed}
-    _emit(result, output)
+    t0 = time.monotonic()
+    # Resolve the seed up front so the emitter and the store footer
+    # record the same value.
+    if seed == -1 or seed is None:
+        seed = generate_seed(normalizer.metadata)
+    emitter.close(normalizer.metadata, seed, success=True,
+                  causality=normalizer.causality.to_json())
+    if store is not None:
+        store.close(metadata=normalizer.metadata, seed=seed, success=True)
+    _record_emit(t0)
     return 0
 
 
+# ── Watch mode ──────────────────────────────────────────────────────
+
+_WATCH_POLL = 0.5  # seconds between source mtime checks
+
+
+def _watch(input, output, seed, trace_format="binary", py_engine="instrument"):
+    """Re-run the pipeline whenever the source file changes.
+
+    Unchanged source replays entirely from the content-keyed cache
+    (instrument and compile skip), so an iteration costs little more
+    than the traced program's own runtime. The seed locks to the first
+    successful run, keeping layouts comparable across edits, and each
+    re-run writes a trace diff against the previous output next to the
+    JSON (``<stem>.diff.json``) — common prefix/suffix lengths plus the
+    changed window — so consumers can splice instead of rebuilding.
+    """
+    output = _resolve_output(input, output)
+    diff_path = os.path.splitext(output)[0] + ".diff.json"
+    prev = None
+    last_mtime = os.path.getmtime(input)
+
+    try:
+        while True:
+            started = time.monotonic()
+            rc = deal(input, output, seed,
+                      trace_format=trace_format, py_engine=py_engine)
+            elapsed = time.monotonic() - started
+
+            current = None
+            if os.path.exists(output):
+                try:
+                    with open(output) as f:
+                        current = json.load(f)
+                except ValueError:
+                    pass
+            if current is not None:
+                seed = current.get("seed", seed)
+                if prev is None:
+                    print(f"[watch] initial run in {elapsed:.2f}s (rc={rc}); "
+                          f"watching {input} — Ctrl-C to stop", file=sys.stderr)
+                else:
+                    d = tracediff.write_diff(prev, current, diff_path)
+                    unchanged = d["common_prefix"] + d["common_suffix"]
+                    print(f"[watch] re-ran in {elapsed:.2f}s (rc={rc}): "
+                          f"{unchanged} records unchanged, "
+                          f"+{len(d['added'])} -{d['removed']} → {diff_path}",
+                          file=sys.stderr)
+                prev = current
+
+            while True:
+                time.sleep(_WATCH_POLL)
+                try:
+                    mtime = os.path.getmtime(input)
+                except OSError:
+                    continue  # editors replace the file on save
+                if mtime != last_mtime:
+                    last_mtime = mtime
+                    break
+    except KeyboardInterrupt:
+        return 0
+
+
 def main():
     ap = argparse.ArgumentParser(description="Instrument, compile, run, and normalize.")
     ap.add_argument("input_file", help="Source file (.c or .py)")
@@ -195,6 +679,28 @@ def main():
         const=True,
         default=False,
     )
+    ap.add_argument(
+        "-t",
+        "--trace-format",
+        help="Trace emission format (binary is the fast path; text is for debugging)",
+        choices=["binary", "text"],
+        default="binary",
+    )
+    ap.add_argument(
+        "-e",
+        "--py-engine",
+        help="Python tracing engine: rewrite the source (instrument), run it "
+             "under sys.monitoring (monitoring, CPython 3.12+), or pick "
+             "monitoring when the interpreter supports it (auto)",
+        choices=["instrument", "monitoring", "auto"],
+        default="instrument",
+    )
+    ap.add_argument(
+        "-w",
+        "--watch",
+        help="Re-run on source changes, emitting a trace diff per iteration",
+        action="store_true",
+    )
     args = ap.parse_args()
 
     if not os.path.exists(args.input_file):
@@ -225,7 +731,11 @@ def main():
             seed = existing_data.get("seed", None)
         else:
             seed = -1
-    return deal(args.input_file, args.output, seed)
+    if args.watch:
+        return _watch(args.input_file, args.output, seed,
+                      trace_format=args.trace_format, py_engine=args.py_engine)
+    return deal(args.input_file, args.output, seed, trace_format=args.trace_format,
+                py_engine=args.py_engine)
 
 
 def _emit(data, output_path):
@@ -0,0 +1,104 @@
+"""Trace diff between two pipeline runs (watch mode).
+
+An edit-run-inspect iteration usually changes a contiguous stretch of the
+trace: everything before the edited code replays identically, and often a
+tail (teardown, later functions) does too. The diff captures exactly
+that shape — the length of the common prefix and suffix plus the new
+records in between — so watch mode can report what an edit actually
+changed and a consumer can splice the window instead of reprocessing the
+whole trace.
+
+Records are compared semantically: interned v2 fields are resolved
+through each run's own string table, and positional ids, scope ids and
+raw addresses (ASLR shifts them between runs; the stable ``a<id>``
+tokens don't) are ignored, so re-running unchanged source diffs empty.
+"""
+
+import json
+
+from normalize import INTERNED_FIELDS
+
+# Fields whose values shift between runs without the trace meaning
+# anything different: ids are positional, scope ids renumber with the
+# call tree, and raw hex addresses move with ASLR.
+_POSITIONAL_FIELDS = ("id", "scope")
+
+
+def _resolve(value, strings):
+    if isinstance(value, int) and strings is not None and 0 <= value < len(strings):
+        return strings[value]
+    return value
+
+
+def _comparable(trace, strings):
+    """A run-independent view of one record, for equality testing."""
+    t = {}
+    for key, value in trace.items():
+        if key in _POSITIONAL_FIELDS:
+            continue
+        if key in INTERNED_FIELDS:
+            value = _resolve(value, strings)
+        if isinstance(value, str) and value.startswith("0x"):
+            continue  # raw address — stable token fields carry identity
+        if key == "deltas":
+            value = [
+                {k: v for k, v in d.items() if k not in _POSITIONAL_FIELDS}
+                for d in value
+            ]
+        t[key] = value
+    return t
+
+
+def _resolved_record(trace, strings):
+    """The record with interned fields resolved — diff output is
+    self-contained, the old file's string table never applies to it."""
+    if strings is None:
+        return trace
+    t = dict(trace)
+    for field in INTERNED_FIELDS:
+        if field in t:
+            t[field] = _resolve(t[field], strings)
+    return t
+
+
+def diff(old_result, new_result):
+    """Diff two result JSONs; returns the diff dict (see module doc)."""
+    old_strings = old_result.get("strings") if old_result.get("version") == 2 else None
+    new_strings = new_result.get("strings") if new_result.get("version") == 2 else None
+    old_traces = old_result.get("traces", [])
+    new_traces = new_result.get("traces", [])
+
+    a = [_comparable(t, old_strings) for t in old_traces]
+    b = [_comparable(t, new_strings) for t in new_traces]
+
+    limit = min(len(a), len(b))
+    prefix = 0
+    while prefix < limit and a[prefix] == b[prefix]:
+        prefix += 1
+    suffix = 0
+    while (suffix < limit - prefix
+           and a[len(a) - 1 - suffix] == b[len(b) - 1 - suffix]):
+        suffix += 1
+
+    added = [
+        _resolved_record(t, new_strings)
+        for t in new_traces[prefix: len(new_traces) - suffix]
+    ]
+    return {
+        "version": 1,
+        "old_total": len(a),
+        "new_total": len(b),
+        "common_prefix": prefix,
+        "common_suffix": suffix,
+        "removed": len(a) - prefix - suffix,
+        "added": added,
+    }
+
+
+def write_diff(old_result, new_result, path):
+    """Diff and write to ``path``; returns the diff for the caller's
+    summary line."""
+    result = diff(old_result, new_result)
+    with open(path, "w") as f:
+        json.dump(result, f)
+    return result
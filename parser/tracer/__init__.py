@@ -2,7 +2,12 @@ from .base import LanguageSupport
 from .core import SymbolTable, extract_var_name, get_text
 from .registry import get_language, supported_extensions
 
+# Bump whenever instrumentation output changes — it keys the pipeline's
+# cache of instrumented sources and compiled executables.
+INSTRUMENTER_VERSION = "2025.08.3"
+
 __all__ = [
+    "INSTRUMENTER_VERSION",
     "LanguageSupport",
     "SymbolTable",
     "extract_var_name",
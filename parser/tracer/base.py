@@ -11,6 +11,10 @@ class LanguageSupport(ABC):
       2. Subclass ``LanguageSupport``
       3. Decorate with ``@register``
       4. Import it in ``languages/__init__.py``
+
+    All three analysis stages accept an optional pre-parsed ``tree`` so the
+    pipeline can parse the source once and share the AST; when ``tree`` is
+    omitted each stage parses for itself (standalone use).
     """
 
     name: str
@@ -21,13 +25,20 @@ class LanguageSupport(ABC):
         """Return the tree-sitter ``Language`` object."""
 
     @abstractmethod
-    def analyze_types(self, ts_parser, code_bytes) -> SymbolTable:
+    def analyze_types(self, ts_parser, code_bytes, tree=None) -> SymbolTable:
         """Walk the AST and build a symbol table of variable types."""
 
     @abstractmethod
-    def collect_metadata(self, ts_parser, code_bytes, source_file) -> dict:
+    def collect_metadata(self, ts_parser, code_bytes, source_file, tree=None) -> dict:
         """Return a dict of metadata about the source file."""
 
     @abstractmethod
-    def instrument(self, ts_parser, code_bytes, symbol_table, metadata) -> str:
-        """Return the instrumented source code as a string."""
+    def instrument(self, ts_parser, code_bytes, symbol_table, metadata,
+                   trace_format="binary", tree=None) -> str:
+        """Return the instrumented source code as a string.
+
+        ``trace_format`` selects the trace emission: ``"binary"`` for the
+        fixed-layout record stream (see ``tracer.binformat``), ``"text"``
+        for the human-readable NUL-separated debug format. Backends without
+        a binary runtime may ignore it and always emit text.
+        """
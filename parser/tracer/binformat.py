@@ -0,0 +1,238 @@
+"""Binary trace record format shared by the injected C runtime and the decoder.
+
+The instrumented binary writes a compact record stream to stdout instead of
+formatted text: a 5-byte magic header, then a sequence of records. Strings the
+instrumenter knows at compile time (subjects, conditions, subtypes, …) are
+interned — each distinct string is emitted once as a STR record and referenced
+by a small integer ID afterwards, so hot loops never re-format or re-transmit
+the same text.
+
+Stream layout (all integers little-endian):
+
+    magic   : b"\\x00TRC1"
+    EVENT   : 0x02, u8 event_type, fields…, 0xFF
+    field   : u8 kind, payload
+              kind 0 = interned string ref  (u32 id)
+              kind 1 = signed integer       (i64)
+              kind 2 = double               (f64)
+              kind 3 = pointer              (u64)
+              kind 4 = inline string        (u16 len, utf-8 bytes)
+              kind 5 = char                 (u8)
+              kind 6 = interned string def  (u32 id, u16 len, utf-8 bytes)
+              kind 7 = interned address def (u32 id, u64 address, u32 size)
+              kind 8 = interned address ref (u32 id)
+
+    A string's first use is a kind-6 field that both defines the table entry
+    and stands for the value; later uses are 4-byte kind-0 references.
+
+    Addresses work the same way: the runtime assigns each distinct pointer a
+    small ID on first sight (kind 7, carrying the raw address and the object
+    size) and emits 4-byte kind-8 references afterwards. The decoder turns a
+    definition into a synthesized ADDR line (``ADDR id address size``) ahead
+    of the record that introduced it, and both kinds decode to the stable
+    token ``a<id>`` — consumers key on the token and never parse hex.
+
+The decoder turns each EVENT back into the NUL-separated line format that
+``normalize.stdin_to_json`` already consumes, so everything downstream of the
+decoder is format-agnostic.
+"""
+
+import struct
+
+MAGIC = b"\x00TRC1"
+
+# Event type tags. Order is the wire format — append only, never reorder.
+EVENT_TYPES = [
+    "META",
+    "CALL",
+    "PARAM",
+    "DECL",
+    "ASSIGN",
+    "READ",
+    "UPDATE",
+    "LOOP",
+    "CONDITION",
+    "BRANCH",
+    "CASE",
+    "SWITCH",
+    "TERNARY",
+    "RETURN",
+    "EXTERNAL_CALL",
+    "LOOP_AGG",
+    "ADDR",
+]
+
+_TAG_EVENT = 0x02
+_FIELD_END = 0xFF
+
+_U32 = struct.Struct("<I")
+_U16 = struct.Struct("<H")
+_I64 = struct.Struct("<q")
+_F64 = struct.Struct("<d")
+_U64 = struct.Struct("<Q")
+
+
+def is_binary_trace(data: bytes) -> bool:
+    """True if the raw trace output uses the binary record format."""
+    return data[: len(MAGIC)] == MAGIC
+
+
+class Decoder:
+    """Incremental decoder: feed raw chunks, get back complete trace lines.
+
+    Partial records at the end of a chunk are kept in an internal buffer and
+    completed by the next ``feed`` call, so the decoder works equally well on
+    a full capture or a live pipe.
+    """
+
+    def __init__(self):
+        self._buf = b""
+        self._strings: dict[int, str] = {}
+        self._seen_magic = False
+        # ADDR lines synthesized by address definitions mid-record; they are
+        # released just before the record that introduced them.
+        self._extra_lines: list[str] = []
+
+    @classmethod
+    def resume(cls, strings=None):
+        """A decoder positioned mid-stream: the magic is already consumed
+        and the interned-string table restored. Used by the trace store to
+        decode an individual block without replaying everything before it.
+        """
+        decoder = cls()
+        decoder._seen_magic = True
+        if strings:
+            decoder._strings.update(strings)
+        return decoder
+
+    def feed(self, chunk: bytes) -> list[str]:
+        self._buf += chunk
+        if not self._seen_magic:
+            if len(self._buf) < len(MAGIC):
+                return []
+            if self._buf[: len(MAGIC)] != MAGIC:
+                raise ValueError("Not a binary trace stream (bad magic)")
+            self._buf = self._buf[len(MAGIC):]
+            self._seen_magic = True
+
+        lines = []
+        pos = 0
+        buf = self._buf
+        while pos < len(buf):
+            consumed, line = self._decode_record(buf, pos)
+            if consumed == 0:
+                # Incomplete record — wait for more bytes. Any ADDR lines it
+                # produced are dropped too; the retry regenerates them.
+                self._extra_lines.clear()
+                break
+            pos += consumed
+            if self._extra_lines:
+                lines.extend(self._extra_lines)
+                self._extra_lines.clear()
+            if line is not None:
+                lines.append(line)
+        self._buf = buf[pos:]
+        return lines
+
+    def finish(self) -> list[str]:
+        """Flush: any trailing partial record is dropped (crash truncation)."""
+        self._buf = b""
+        return []
+
+    # ── record decoding ──────────────────────────────────────────
+
+    def _decode_record(self, buf: bytes, pos: int):
+        """Return (bytes_consumed, line_or_None); (0, None) if incomplete."""
+        tag = buf[pos]
+        if tag == _TAG_EVENT:
+            if pos + 2 > len(buf):
+                return 0, None
+            ev_type = buf[pos + 1]
+            fields = []
+            cur = pos + 2
+            while True:
+                if cur >= len(buf):
+                    return 0, None
+                kind = buf[cur]
+                cur += 1
+                if kind == _FIELD_END:
+                    break
+                consumed, text = self._decode_field(buf, cur, kind)
+                if consumed == 0:
+                    return 0, None
+                cur += consumed
+                fields.append(text)
+            try:
+                name = EVENT_TYPES[ev_type]
+            except IndexError:
+                raise ValueError(f"Unknown event type tag {ev_type}")
+            return cur - pos, "\0".join([name] + fields)
+
+        raise ValueError(f"Corrupt trace stream: unexpected tag {tag:#x}")
+
+    def _decode_field(self, buf: bytes, pos: int, kind: int):
+        """Return (bytes_consumed, text); (0, None) if incomplete."""
+        if kind == 0:
+            if pos + 4 > len(buf):
+                return 0, None
+            str_id = _U32.unpack_from(buf, pos)[0]
+            return 4, self._strings.get(str_id, f"<str#{str_id}>")
+        if kind == 1:
+            if pos + 8 > len(buf):
+                return 0, None
+            return 8, str(_I64.unpack_from(buf, pos)[0])
+        if kind == 2:
+            if pos + 8 > len(buf):
+                return 0, None
+            return 8, "%f" % _F64.unpack_from(buf, pos)[0]
+        if kind == 3:
+            if pos + 8 > len(buf):
+                return 0, None
+            return 8, hex(_U64.unpack_from(buf, pos)[0])
+        if kind == 4:
+            if pos + 2 > len(buf):
+                return 0, None
+            length = _U16.unpack_from(buf, pos)[0]
+            end = pos + 2 + length
+            if end > len(buf):
+                return 0, None
+            return 2 + length, buf[pos + 2 : end].decode("utf-8", errors="replace")
+        if kind == 5:
+            if pos + 1 > len(buf):
+                return 0, None
+            return 1, chr(buf[pos])
+        if kind == 6:
+            if pos + 6 > len(buf):
+                return 0, None
+            str_id = _U32.unpack_from(buf, pos)[0]
+            length = _U16.unpack_from(buf, pos + 4)[0]
+            end = pos + 6 + length
+            if end > len(buf):
+                return 0, None
+            text = buf[pos + 6 : end].decode("utf-8", errors="replace")
+            self._strings[str_id] = text
+            return 6 + length, text
+        if kind == 7:
+            if pos + 16 > len(buf):
+                return 0, None
+            addr_id = _U32.unpack_from(buf, pos)[0]
+            address = _U64.unpack_from(buf, pos + 4)[0]
+            size = _U32.unpack_from(buf, pos + 12)[0]
+            token = f"a{addr_id}"
+            self._extra_lines.append(
+                "\0".join(["ADDR", token, hex(address), str(size)])
+            )
+            return 16, token
+        if kind == 8:
+            if pos + 4 > len(buf):
+                return 0, None
+            return 4, f"a{_U32.unpack_from(buf, pos)[0]}"
+        raise ValueError(f"Corrupt trace stream: unknown field kind {kind:#x}")
+
+
+def decode_bytes(data: bytes) -> list[str]:
+    """Decode a complete binary trace capture into NUL-separated lines."""
+    decoder = Decoder()
+    lines = decoder.feed(data)
+    decoder.finish()
+    return lines
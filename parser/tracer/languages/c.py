@@ -8,6 +8,7 @@ from tree_sitter_c import language
 from ..base import LanguageSupport
 from ..core import SymbolTable, extract_var_name, get_text
 from ..registry import register
+from .c_runtime import RUNTIME_SOURCE
 
 KEYWORDS = {
     "printf",
@@ -63,7 +64,6 @@ def _extract_condition(node, code_bytes: bytes):
     raw = get_text(condition, code_bytes)
     cond_expr = raw
     cond_text = raw[1:-1] if raw.startswith("(") and raw.endswith(")") else raw
-    cond_text = cond_text.replace("%", "%%").replace('"', '\\"')
     return cond_text, cond_expr
 
 
@@ -71,13 +71,14 @@ def _extract_condition(node, code_bytes: bytes):
 
 
 class CTypeAnalyzer:
-    def __init__(self, ts_parser, code_bytes):
+    def __init__(self, ts_parser, code_bytes, tree=None):
         self.ts_parser = ts_parser
         self.code_bytes = code_bytes
+        self.tree = tree
         self.symbol_table = SymbolTable()
 
     def analyze(self) -> SymbolTable:
-        tree = self.ts_parser.parse(self.code_bytes)
+        tree = self.tree if self.tree is not None else self.ts_parser.parse(self.code_bytes)
         self._collect(tree.root_node)
         return self.symbol_table
 
@@ -136,10 +137,11 @@ class CTypeAnalyzer:
 
 
 class CMetadataCollector:
-    def __init__(self, ts_parser, code_bytes, source_file):
+    def __init__(self, ts_parser, code_bytes, source_file, tree=None):
         self.ts_parser = ts_parser
         self.code_bytes = code_bytes
         self.source_file = source_file
+        self.tree = tree
         self.num_functions = 0
         self.num_variables = 0
         self.num_loops = 0
@@ -156,7 +158,7 @@ class CMetadataCollector:
 
     def collect(self) -> dict:
         code_text = self.code_bytes.decode("utf-8")
-        tree = self.ts_parser.parse(self.code_bytes)
+        tree = self.tree if self.tree is not None else self.ts_parser.parse(self.code_bytes)
         self._extract_includes(tree.root_node)
         self._walk(tree.root_node, depth=0)
         self._count_comments(tree.root_node)
@@ -267,7 +269,23 @@ class CMetadataCollector:
 # ── Code instrumentation ────────────────────────────────────────────
 
 
+def _c_literal(text: str) -> str:
+    """Escape arbitrary text for embedding in a C string literal."""
+    return (
+        str(text)
+        .replace("\\", "\\\\")
+        .replace('"', '\\"')
+        .replace("\n", "\\n")
+    )
+
+
 class CInstrumenter:
+    LOOP_NODE_TYPES = {
+        "while_statement": "while",
+        "for_statement": "for",
+        "do_statement": "do-while",
+    }
+
     EXCLUDE_TYPES = {
         "declaration",
         "init_declarator",
@@ -278,11 +296,25 @@ class CInstrumenter:
         "update_expression",
     }
 
-    def __init__(self, ts_parser, code_bytes, symbol_table, metadata=None):
+    # Maps printf-style format specs onto the runtime's typed field writers.
+    BINARY_EMITTERS = {
+        "%d": "__trc_i",
+        "%ld": "__trc_i",
+        "%f": "__trc_d",
+        "%lf": "__trc_d",
+        "%c": "__trc_c",
+        "%s": "__trc_q",
+        "%p": "__trc_a",  # address-interned; special-cased to add sizeof
+    }
+
+    def __init__(self, ts_parser, code_bytes, symbol_table, metadata=None,
+                 trace_format="binary", tree=None):
         self.ts_parser = ts_parser
         self.code_bytes = code_bytes
+        self.tree = tree
         self.symbol_table = symbol_table
         self.metadata = metadata or {}
+        self.trace_format = trace_format
         self.lines = code_bytes.decode("utf-8").splitlines()
         self.insertions: dict[int, list[str]] = {}
         self.pre_insertions: dict[int, list[str]] = {}
@@ -296,8 +328,12 @@ class CInstrumenter:
         # Track declared variables to prevent reading before declaration
         self.declared_vars: set[str] = set()
         self.local_var_types: dict[str, str] = {}
+        # Loop sampling: one site per loop body, nested sites stacked so an
+        # unsampled outer iteration also mutes everything inside it
+        self.loop_sites: list[int] = []
+        self._loop_stack: list[int] = []
     def instrument(self) -> str:
-        tree = self.ts_parser.parse(self.code_bytes)
+        tree = self.tree if self.tree is not None else self.ts_parser.parse(self.code_bytes)
         self._traverse(tree.root_node)
         return self._build_output()
 
@@ -309,8 +345,35 @@ class CInstrumenter:
     def _add_before(self, line_idx, code):
         self.pre_insertions.setdefault(line_idx, []).append(code)
 
+    def _make_trace(self, parts):
+        if self.trace_format == "binary":
+            return self._make_trace_binary(parts)
+        return self._make_trace_text(parts)
+
     @staticmethod
-    def _make_trace(parts):
+    def _make_trace_binary(parts):
+        """Emit one fixed-layout record via the injected trace runtime."""
+        event = parts[0]
+        statements = [f"__trc_begin(__TRC_EV_{event})"]
+        for part in parts[1:]:
+            if isinstance(part, tuple):
+                fmt, arg = part
+                if fmt == "%p":
+                    # Interned address: one ADDR definition per distinct
+                    # pointer, 4-byte references afterwards. sizeof is
+                    # unevaluated, so the deref never touches memory.
+                    statements.append(f"__trc_a(({arg}), sizeof(*({arg})))")
+                    continue
+                emitter = CInstrumenter.BINARY_EMITTERS.get(fmt, "__trc_i")
+                statements.append(f"{emitter}(({arg}))")
+            else:
+                statements.append(f'__trc_s("{_c_literal(part)}")')
+        statements.append("__trc_end()")
+        return "    " + "; ".join(statements) + ";"
+
+    @staticmethod
+    def _make_trace_text(parts):
+        """Debug mode: the original NUL-separated printf emission."""
         fmt_parts = []
         args = []
         for part in parts:
@@ -318,8 +381,9 @@ class CInstrumenter:
                 fmt_parts.append(part[0])
                 args.append(part[1])
             else:
+                lit = str(part).replace("%", "%%").replace('"', '\\"')
                 fmt_parts.append("%s")
-                args.append(f'"{part}"')
+                args.append(f'"{lit}"')
 
         statements = []
         for i, (fmt, arg) in enumerate(zip(fmt_parts, args)):
@@ -348,12 +412,21 @@ class CInstrumenter:
                     break
         
         result = []
-        
+
         # Add stdio.h if not present
         if not has_stdio:
             result.append("#include <stdio.h>")
             result.append("")
-        
+
+        # Binary mode pulls in the record-writing runtime; its own includes
+        # are self-contained, so it can sit above the user's code.
+        if self.trace_format == "binary":
+            result.append(RUNTIME_SOURCE)
+            # Per-loop-site sampling state (counter + this-iteration flag)
+            for site in self.loop_sites:
+                result.append(f"long long __trc_n_{site} = 0;")
+                result.append(f"int __trc_on_{site} = 1;")
+
         # Add global stack depth variable
         result.append("int __stack_depth = 0;")
         
@@ -369,11 +442,72 @@ class CInstrumenter:
     # ── AST traversal ────────────────────────────────────────────
 
     def _traverse(self, node):
+        # Loop sites are entered before the visitor runs so the sampling
+        # gate lands ahead of the LOOP record on the body's opening line.
+        entered_loop = self._maybe_enter_loop(node)
         visitor = getattr(self, f"_visit_{node.type}", None)
         if visitor:
             visitor(node)
         for child in node.children:
             self._traverse(child)
+        if entered_loop:
+            self._loop_stack.pop()
+
+    def _maybe_enter_loop(self, node) -> bool:
+        """Plant the sampling gate around a loop body (binary mode only).
+
+        Each site gets an iteration counter reset ahead of the loop. The
+        gate at the top of the body asks the runtime whether this iteration
+        should trace and mutes record emission if not (or if any enclosing
+        loop iteration is unsampled); after the loop, muting reverts to the
+        enclosing state and a LOOP_AGG record reports the exact count.
+        """
+        if self.trace_format != "binary":
+            return False
+        subtype = self.LOOP_NODE_TYPES.get(node.type)
+        if not subtype:
+            return False
+        body = node.child_by_field_name("body")
+        if not body or body.type != "compound_statement":
+            return False
+
+        site = len(self.loop_sites)
+        self.loop_sites.append(site)
+
+        outer = " && ".join(f"__trc_on_{s}" for s in self._loop_stack) or "1"
+        start = body.start_point[0]
+        # Anchor the post-loop statements after the whole statement, not
+        # the body: a do-while may continue past the body's `}` with
+        # `while (cond);` on its own line, and inserting between the two
+        # would split the statement. Identical to the body end for
+        # for/while and single-line `} while (cond);`.
+        end = node.end_point[0]
+        cond_text, _ = _extract_condition(node, self.code_bytes)
+
+        self._add_before(node.start_point[0], f"    __trc_n_{site} = 0;")
+        self._add_after(
+            start,
+            f"    __trc_on_{site} = __trc_loop_sample(++__trc_n_{site});"
+        )
+        self._add_after(
+            start, f"    __trc_muted = !(__trc_on_{site} && {outer});"
+        )
+        self._add_after(end, f"    __trc_muted = !({outer});")
+        agg = "; ".join(
+            [
+                "__trc_begin(__TRC_EV_LOOP_AGG)",
+                f'__trc_s("{_c_literal(subtype)}")',
+                f'__trc_s("{_c_literal(cond_text)}")',
+                f"__trc_i(__trc_n_{site})",
+                f'__trc_s("{node.start_point[0] + 1}")',
+                "__trc_i((__stack_depth))",
+                "__trc_end()",
+            ]
+        )
+        self._add_after(end, "    " + agg + ";")
+
+        self._loop_stack.append(site)
+        return True
 
     def _collect_reads(self, node):
         reads = []
@@ -427,7 +561,10 @@ class CInstrumenter:
         start_line = body.start_point[0]
 
         if func_name == "main":
-            self._add_after(start_line, "    setbuf(stdout, NULL);")
+            if self.trace_format == "binary":
+                self._add_after(start_line, "    __trace_init();")
+            else:
+                self._add_after(start_line, "    setbuf(stdout, NULL);")
 
         if func_name == "main" and self.metadata:
             for key, val in self.metadata.items():
@@ -643,9 +780,8 @@ class CInstrumenter:
         value_node = node.child_by_field_name("value")
         if value_node:
             value_text = get_text(value_node, self.code_bytes)
-            safe_text = value_text.replace("%", "%%").replace('"', '\\"')
             trace = self._make_trace(
-                ["CASE", safe_text, str(line + 1), ("%d", "__stack_depth")]
+                ["CASE", value_text, str(line + 1), ("%d", "__stack_depth")]
             )
         else:
             trace = self._make_trace(
@@ -685,12 +821,11 @@ class CInstrumenter:
         if not condition:
             return
         cond_text = get_text(condition, self.code_bytes)
-        safe_text = cond_text.replace("%", "%%").replace('"', '\\"')
         line = node.start_point[0]
         trace = self._make_trace(
             [
                 "TERNARY",
-                safe_text,
+                cond_text,
                 ("%d", cond_text),
                 str(line + 1),
                 ("%d", "__stack_depth"),
@@ -890,11 +1025,14 @@ class CLanguage(LanguageSupport):
     def get_ts_language(self):
         return Language(language())
 
-    def analyze_types(self, ts_parser, code_bytes):
-        return CTypeAnalyzer(ts_parser, code_bytes).analyze()
+    def analyze_types(self, ts_parser, code_bytes, tree=None):
+        return CTypeAnalyzer(ts_parser, code_bytes, tree).analyze()
 
-    def collect_metadata(self, ts_parser, code_bytes, source_file):
-        return CMetadataCollector(ts_parser, code_bytes, source_file).collect()
+    def collect_metadata(self, ts_parser, code_bytes, source_file, tree=None):
+        return CMetadataCollector(ts_parser, code_bytes, source_file, tree).collect()
 
-    def instrument(self, ts_parser, code_bytes, symbol_table, metadata):
-        return CInstrumenter(ts_parser, code_bytes, symbol_table, metadata).instrument()
+    def instrument(self, ts_parser, code_bytes, symbol_table, metadata,
+                   trace_format="binary", tree=None):
+        return CInstrumenter(
+            ts_parser, code_bytes, symbol_table, metadata, trace_format, tree
+        ).instrument()
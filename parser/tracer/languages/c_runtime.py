@@ -0,0 +1,264 @@
+"""Injected C trace runtime.
+
+``CInstrumenter`` prepends this source block to instrumented files when
+emitting binary traces. It provides the record writers the instrumented code
+calls into (``__trc_begin``/``__trc_s``/…) so a traced event costs a handful
+of buffer writes instead of a chain of formatted printf calls.
+
+Wire format lives in ``tracer.binformat`` — the two must stay in sync, which
+is why the event-type defines are generated from the same table.
+"""
+
+from ..binformat import EVENT_TYPES
+
+
+def _event_defines() -> str:
+    return "\n".join(
+        f"#define __TRC_EV_{name} {i}" for i, name in enumerate(EVENT_TYPES)
+    )
+
+
+RUNTIME_SOURCE = (
+    """\
+/* ── injected trace runtime (binary record format) ─────────────────── */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+"""
+    + _event_defines()
+    + """
+
+#define __TRC_STR_TBL 1024
+#define __TRC_ADDR_TBL 1024
+#define __TRC_BUF_SIZE (1 << 16)
+#define __TRC_LOOP_FULL 64
+
+/* Loop sampling gate. The instrumenter plants a per-site iteration counter
+ * at the top of every loop body; the first __TRC_LOOP_FULL iterations trace
+ * at full fidelity, then only power-of-two iterations do (exponential
+ * backoff). While an iteration is unsampled __trc_muted suppresses every
+ * record writer, and a LOOP_AGG record after the loop carries the exact
+ * iteration count. */
+static int __trc_muted = 0;
+
+static int __trc_loop_sample(long long n) {
+    if (n <= __TRC_LOOP_FULL)
+        return 1;
+    return (n & (n - 1)) == 0;
+}
+
+static const char *__trc_keys[__TRC_STR_TBL];
+static unsigned int __trc_ids[__TRC_STR_TBL];
+static unsigned int __trc_next_str = 0;
+
+/* Block-buffered sink. Records accumulate in a 64KB buffer and go out in
+ * large writes; the signal/atexit handlers below flush whatever is pending,
+ * so a crashing program still leaves a usable partial trace. write(2) is
+ * async-signal-safe, which is why the sink bypasses stdio entirely — it
+ * also keeps the record stream separate from the program's own stdout. */
+static unsigned char __trc_buf[__TRC_BUF_SIZE];
+static size_t __trc_len = 0;
+static int __trc_fd = 1;
+
+static void __trc_flush(void) {
+    size_t off = 0;
+    while (off < __trc_len) {
+        ssize_t n = write(__trc_fd, __trc_buf + off, __trc_len - off);
+        if (n <= 0)
+            break;
+        off += (size_t)n;
+    }
+    __trc_len = 0;
+}
+
+static void __trc_on_signal(int sig) {
+    __trc_flush();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void __trc_raw(const void *p, size_t n) {
+    if (__trc_len + n > __TRC_BUF_SIZE)
+        __trc_flush();
+    memcpy(__trc_buf + __trc_len, p, n);
+    __trc_len += n;
+}
+static void __trc_u32(unsigned int v) { __trc_raw(&v, 4); }
+static void __trc_u16(unsigned short v) { __trc_raw(&v, 2); }
+
+static void __trc_begin(unsigned char type) {
+    unsigned char tag = 2;
+    if (__trc_muted)
+        return;
+    __trc_raw(&tag, 1);
+    __trc_raw(&type, 1);
+}
+static void __trc_end(void) { unsigned char k = 0xFF; if (__trc_muted) return; __trc_raw(&k, 1); }
+
+/* Interned string field. Keyed on pointer identity — the instrumenter always
+ * passes literals, which the compiler pools. First sight emits a defining
+ * field (kind 6) carrying the bytes; later uses are 4-byte references. */
+static void __trc_s(const char *s) {
+    unsigned int i = (unsigned int)(((unsigned long)s >> 3) % __TRC_STR_TBL);
+    unsigned int probes = 0;
+    unsigned short len;
+    if (__trc_muted)
+        return;
+    while (__trc_keys[i]) {
+        if (__trc_keys[i] == s) {
+            unsigned char k = 0;
+            __trc_raw(&k, 1);
+            __trc_u32(__trc_ids[i]);
+            return;
+        }
+        if (++probes == __TRC_STR_TBL)
+            break; /* table full — keep emitting defining fields */
+        i = (i + 1) % __TRC_STR_TBL;
+    }
+    if (probes < __TRC_STR_TBL) {
+        __trc_keys[i] = s;
+        __trc_ids[i] = __trc_next_str;
+    }
+    {
+        unsigned char k = 6;
+        len = (unsigned short)strlen(s);
+        __trc_raw(&k, 1);
+        __trc_u32(__trc_next_str);
+        __trc_u16(len);
+        __trc_raw(s, len);
+    }
+    __trc_next_str++;
+}
+static void __trc_i(long long v) { unsigned char k = 1; if (__trc_muted) return; __trc_raw(&k, 1); __trc_raw(&v, 8); }
+static void __trc_d(double v) { unsigned char k = 2; if (__trc_muted) return; __trc_raw(&k, 1); __trc_raw(&v, 8); }
+static void __trc_p(const void *p) { unsigned char k = 3; if (__trc_muted) return; unsigned long long v = (unsigned long long)p; __trc_raw(&k, 1); __trc_raw(&v, 8); }
+static void __trc_q(const char *s) { unsigned char k = 4; if (__trc_muted) return; unsigned short len = s ? (unsigned short)strlen(s) : 0; __trc_raw(&k, 1); __trc_u16(len); if (s) __trc_raw(s, len); }
+static void __trc_c(char c) { unsigned char k = 5; if (__trc_muted) return; __trc_raw(&k, 1); __trc_raw(&c, 1); }
+
+/* Interned address field. Same scheme as __trc_s, keyed on the pointer
+ * value: first sight emits a defining field (kind 7) carrying the raw
+ * address and object size; later uses are 4-byte references. */
+static unsigned long long __trc_addr_keys[__TRC_ADDR_TBL];
+static unsigned int __trc_addr_ids[__TRC_ADDR_TBL];
+static unsigned char __trc_addr_used[__TRC_ADDR_TBL];
+static unsigned int __trc_next_addr = 0;
+
+static void __trc_a(const void *p, unsigned int size) {
+    unsigned long long key = (unsigned long long)p;
+    unsigned int i = (unsigned int)((key >> 3) % __TRC_ADDR_TBL);
+    unsigned int probes = 0;
+    if (__trc_muted)
+        return;
+    while (__trc_addr_used[i]) {
+        if (__trc_addr_keys[i] == key) {
+            unsigned char k = 8;
+            __trc_raw(&k, 1);
+            __trc_u32(__trc_addr_ids[i]);
+            return;
+        }
+        if (++probes == __TRC_ADDR_TBL)
+            break; /* table full — keep emitting defining fields */
+        i = (i + 1) % __TRC_ADDR_TBL;
+    }
+    if (probes < __TRC_ADDR_TBL) {
+        __trc_addr_used[i] = 1;
+        __trc_addr_keys[i] = key;
+        __trc_addr_ids[i] = __trc_next_addr;
+    }
+    {
+        unsigned char k = 7;
+        __trc_raw(&k, 1);
+        __trc_u32(__trc_next_addr);
+        __trc_raw(&key, 8);
+        __trc_u32(size);
+    }
+    __trc_next_addr++;
+}
+
+static void __trace_init(void) {
+    const char *path = getenv("__TRACE_OUT");
+    if (path) {
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+            __trc_fd = fd;
+    }
+    atexit(__trc_flush);
+    signal(SIGSEGV, __trc_on_signal);
+    signal(SIGFPE, __trc_on_signal);
+    signal(SIGILL, __trc_on_signal);
+    signal(SIGABRT, __trc_on_signal);
+    /* The pipeline SIGTERMs a timed-out child before the hard kill, so
+     * the flush here is what makes partial-trace recovery possible. */
+    signal(SIGTERM, __trc_on_signal);
+#ifdef SIGBUS
+    signal(SIGBUS, __trc_on_signal);
+#endif
+    __trc_raw("\\0TRC1", 5);
+}
+/* ── end trace runtime ──────────────────────────────────────────────── */
+"""
+)
+
+
+# Symbols the instrumented translation unit references. Everything else in
+# the runtime (buffer, string table, flush/signal plumbing) stays ``static``
+# even when the runtime is built as a standalone object.
+EXPORTED_SYMBOLS = (
+    "__trc_muted",
+    "__trc_loop_sample",
+    "__trc_begin",
+    "__trc_end",
+    "__trc_s",
+    "__trc_i",
+    "__trc_d",
+    "__trc_p",
+    "__trc_q",
+    "__trc_c",
+    "__trc_a",
+    "__trace_init",
+)
+
+
+def runtime_object_source() -> str:
+    """The runtime as a standalone translation unit.
+
+    Identical to ``RUNTIME_SOURCE`` except that the symbols instrumented
+    code calls lose their ``static`` so the object can be linked against.
+    The compile daemon (``compiler.py``) builds this once at startup.
+    """
+    src = RUNTIME_SOURCE
+    for name in EXPORTED_SYMBOLS:
+        for ret in ("int", "void"):
+            src = src.replace(f"static {ret} {name}", f"{ret} {name}")
+    return src
+
+
+# Drop-in replacement for the inlined runtime block when linking against the
+# prebuilt object: same event defines, extern declarations instead of
+# definitions. Must declare exactly the EXPORTED_SYMBOLS set.
+RUNTIME_DECLS = (
+    """\
+/* ── trace runtime declarations (definitions in prebuilt object) ────── */
+"""
+    + _event_defines()
+    + """
+
+extern int __trc_muted;
+int __trc_loop_sample(long long n);
+void __trc_begin(unsigned char type);
+void __trc_end(void);
+void __trc_s(const char *s);
+void __trc_i(long long v);
+void __trc_d(double v);
+void __trc_p(const void *p);
+void __trc_q(const char *s);
+void __trc_c(char c);
+void __trc_a(const void *p, unsigned int size);
+void __trace_init(void);
+/* ── end trace runtime declarations ─────────────────────────────────── */
+"""
+)
@@ -55,13 +55,14 @@ KEYWORDS = {
 class PythonTypeAnalyzer:
     """Python is dynamically typed — we just record variable names."""
 
-    def __init__(self, ts_parser, code_bytes):
+    def __init__(self, ts_parser, code_bytes, tree=None):
         self.ts_parser = ts_parser
         self.code_bytes = code_bytes
+        self.tree = tree
         self.symbol_table = SymbolTable()
 
     def analyze(self) -> SymbolTable:
-        tree = self.ts_parser.parse(self.code_bytes)
+        tree = self.tree if self.tree is not None else self.ts_parser.parse(self.code_bytes)
         self._collect(tree.root_node)
         return self.symbol_table
 
@@ -86,10 +87,11 @@ class PythonTypeAnalyzer:
 
 
 class PythonMetadataCollector:
-    def __init__(self, ts_parser, code_bytes, source_file):
+    def __init__(self, ts_parser, code_bytes, source_file, tree=None):
         self.ts_parser = ts_parser
         self.code_bytes = code_bytes
         self.source_file = source_file
+        self.tree = tree
         self.num_functions = 0
         self.num_variables = 0
         self.num_loops = 0
@@ -106,7 +108,7 @@ class PythonMetadataCollector:
 
     def collect(self) -> dict:
         code_text = self.code_bytes.decode("utf-8")
-        tree = self.ts_parser.parse(self.code_bytes)
+        tree = self.tree if self.tree is not None else self.ts_parser.parse(self.code_bytes)
         self._extract_imports(tree.root_node)
         self._walk(tree.root_node, depth=0)
 
@@ -203,9 +205,10 @@ class PythonInstrumenter:
         "parameters",
     }
 
-    def __init__(self, ts_parser, code_bytes, symbol_table, metadata=None):
+    def __init__(self, ts_parser, code_bytes, symbol_table, metadata=None, tree=None):
         self.ts_parser = ts_parser
         self.code_bytes = code_bytes
+        self.tree = tree
         self.symbol_table = symbol_table
         self.metadata = metadata or {}
         self.lines = code_bytes.decode("utf-8").splitlines()
@@ -220,7 +223,7 @@ class PythonInstrumenter:
                 self.defined_functions = set(func_str.split(","))
 
     def instrument(self) -> str:
-        tree = self.ts_parser.parse(self.code_bytes)
+        tree = self.tree if self.tree is not None else self.ts_parser.parse(self.code_bytes)
         self._traverse(tree.root_node)
         return self._build_output()
 
@@ -772,13 +775,16 @@ class PythonLanguage(LanguageSupport):
     def get_ts_language(self):
         return Language(language())
 
-    def analyze_types(self, ts_parser, code_bytes):
-        return PythonTypeAnalyzer(ts_parser, code_bytes).analyze()
+    def analyze_types(self, ts_parser, code_bytes, tree=None):
+        return PythonTypeAnalyzer(ts_parser, code_bytes, tree).analyze()
 
-    def collect_metadata(self, ts_parser, code_bytes, source_file):
-        return PythonMetadataCollector(ts_parser, code_bytes, source_file).collect()
+    def collect_metadata(self, ts_parser, code_bytes, source_file, tree=None):
+        return PythonMetadataCollector(ts_parser, code_bytes, source_file, tree).collect()
 
-    def instrument(self, ts_parser, code_bytes, symbol_table, metadata):
+    def instrument(self, ts_parser, code_bytes, symbol_table, metadata,
+                   trace_format="binary", tree=None):
+        # Python tracing always emits the text format — there is no injected
+        # runtime on this path, so trace_format is accepted but ignored.
         return PythonInstrumenter(
-            ts_parser, code_bytes, symbol_table, metadata
+            ts_parser, code_bytes, symbol_table, metadata, tree
         ).instrument()
@@ -0,0 +1,181 @@
+"""sys.monitoring-based tracing engine for Python sources (PEP 669).
+
+Alternative to the source-rewriting instrumenter in ``languages/python.py``:
+the target script runs unmodified under CPython 3.12+ ``sys.monitoring``
+callbacks instead of paying interpreter-level formatted I/O on every
+injected print statement. Callbacks that return ``DISABLE`` for foreign
+files cost nothing after the first hit, so only the student's own code is
+monitored.
+
+Emits the same NUL-separated text records ``normalize.StreamNormalizer``
+consumes: CALL / PARAM on function entry, RETURN on exit, and ASSIGN
+records derived by diffing frame locals between LINE events. Loop and
+branch records are not reconstructed on this path — the assignment and
+call story still drives the visualizer. Note the locals diff observes a
+write when the *next* line starts, so ASSIGN line numbers can read one
+line late compared to the instrumenter.
+
+Selected from run.py with ``--py-engine monitoring`` (or ``auto``).
+
+Usage:
+    python monitor.py <script.py> [args...]
+"""
+
+import os
+import runpy
+import sys
+
+# Values are printed raw like the instrumenter's print statements do;
+# cap them so a huge object repr cannot bloat a record.
+_MAX_VALUE_LEN = 120
+
+
+def _fmt(value):
+    try:
+        text = str(value)
+    except Exception:
+        text = f"<{type(value).__name__}>"
+    text = text.replace("\0", " ").replace("\n", " ")
+    if len(text) > _MAX_VALUE_LEN:
+        text = text[:_MAX_VALUE_LEN] + "…"
+    return text
+
+
+class MonitoringTracer:
+    # Free slot — we are the only monitoring tool in the pipeline
+    TOOL_ID = 2  # sys.monitoring.PROFILER_ID
+
+    def __init__(self, target_path, out=None):
+        self.target = os.path.abspath(target_path)
+        self.out = out or sys.stdout
+        self.depth = 0
+        # id(frame) → {local name: last formatted value}
+        self._snapshots = {}
+
+    # ── record emission ───────────────────────────────────────────
+
+    def _emit(self, *fields):
+        print(*fields, sep="\0", file=self.out)
+
+    @staticmethod
+    def _frame():
+        # 0 = this helper, 1 = the callback, 2 = the monitored frame
+        return sys._getframe(2)
+
+    # ── callbacks ─────────────────────────────────────────────────
+
+    def _on_py_start(self, code, instruction_offset):
+        if code.co_filename != self.target:
+            return sys.monitoring.DISABLE
+        if code.co_name.startswith("<"):
+            return None  # module body / comprehensions: no CALL record
+
+        frame = self._frame()
+        self.depth += 1
+
+        args = []
+        params = []
+        for name in code.co_varnames[: code.co_argcount]:
+            if name in frame.f_locals:
+                value = _fmt(frame.f_locals[name])
+                args.append(value)
+                params.append((name, value))
+
+        self._emit("CALL", code.co_name, *args, self.depth)
+        for name, value in params:
+            self._emit("PARAM", name, value, code.co_firstlineno)
+
+        self._snapshots[id(frame)] = {
+            n: _fmt(v) for n, v in frame.f_locals.items()
+        }
+        return None
+
+    def _on_py_return(self, code, instruction_offset, retval):
+        if code.co_filename != self.target:
+            return sys.monitoring.DISABLE
+        if code.co_name.startswith("<"):
+            return None
+
+        frame = self._frame()
+        self._emit("RETURN", "", _fmt(retval), "0", frame.f_lineno, self.depth)
+        self._snapshots.pop(id(frame), None)
+        self.depth -= 1
+        return None
+
+    def _on_py_unwind(self, code, instruction_offset, exception):
+        # An exception leaving the frame fires PY_UNWIND, not PY_RETURN.
+        # Emit the same RETURN record so stack_depth stays balanced even
+        # when a caller further up catches the exception. PY_UNWIND is
+        # not disableable, so foreign files are skipped with a plain
+        # return instead of DISABLE.
+        if code.co_filename != self.target:
+            return None
+        if code.co_name.startswith("<"):
+            return None
+
+        frame = self._frame()
+        self._emit("RETURN", "", _fmt(exception), "0", frame.f_lineno, self.depth)
+        self._snapshots.pop(id(frame), None)
+        self.depth -= 1
+        return None
+
+    def _on_line(self, code, line_number):
+        if code.co_filename != self.target:
+            return sys.monitoring.DISABLE
+
+        frame = self._frame()
+        snap = self._snapshots.setdefault(id(frame), {})
+        for name, value in frame.f_locals.items():
+            if name.startswith("__"):
+                continue
+            text = _fmt(value)
+            if snap.get(name) != text:
+                snap[name] = text
+                self._emit(
+                    "ASSIGN", name, text,
+                    format(id(value), "x"), line_number, self.depth,
+                )
+        return None
+
+    # ── lifecycle ─────────────────────────────────────────────────
+
+    def install(self):
+        mon = sys.monitoring
+        mon.use_tool_id(self.TOOL_ID, "spiral-monitoring-tracer")
+        mon.register_callback(self.TOOL_ID, mon.events.PY_START, self._on_py_start)
+        mon.register_callback(self.TOOL_ID, mon.events.PY_RETURN, self._on_py_return)
+        mon.register_callback(self.TOOL_ID, mon.events.PY_UNWIND, self._on_py_unwind)
+        mon.register_callback(self.TOOL_ID, mon.events.LINE, self._on_line)
+        mon.set_events(
+            self.TOOL_ID,
+            mon.events.PY_START | mon.events.PY_RETURN
+            | mon.events.PY_UNWIND | mon.events.LINE,
+        )
+
+    def uninstall(self):
+        mon = sys.monitoring
+        mon.set_events(self.TOOL_ID, 0)
+        mon.free_tool_id(self.TOOL_ID)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python monitor.py <script.py> [args...]", file=sys.stderr)
+        return 2
+    if not hasattr(sys, "monitoring"):
+        print("Error: sys.monitoring requires CPython 3.12+", file=sys.stderr)
+        return 1
+
+    tracer = MonitoringTracer(sys.argv[1])
+    sys.argv = sys.argv[1:]  # the script sees itself as argv[0]
+
+    tracer.install()
+    try:
+        runpy.run_path(tracer.target, run_name="__main__")
+    finally:
+        tracer.uninstall()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,185 @@
+"""Chunked, indexed storage for retained traces.
+
+Retained across the data directory, stored result JSONs add up fast and
+any windowed read has to parse the whole file just to reach a few
+thousand records. The store fixes both: the normalized, folded record
+stream — the same records the output JSON's ``traces`` array holds,
+with strings still resolved (pre-interning) — is cut into ~1 MB blocks
+of JSON lines, each compressed independently, with a footer index
+mapping record ranges to block offsets. A reader memory-maps the file
+and inflates only the blocks a request touches; the footer also carries
+the summary the serving layer needs (per-type counts, function table,
+metadata), so a summary request touches no block at all.
+
+Layout:
+
+    MAGIC                 b"TRCS\\x02"
+    block 0..N            zlib-compressed JSON lines, one record each
+    footer                JSON: blocks [[offset, clen, rec_start,
+                          rec_end]], total record count, summary
+    trailer               <Q footer offset> + MAGIC
+
+Record indexes are positions in the folded stream, so they agree with
+the ``traces`` array of the JSON written alongside.
+"""
+
+import json
+import mmap
+import os
+import struct
+import zlib
+
+MAGIC = b"TRCS\x02"
+_TRAILER = struct.Struct("<Q")
+
+# Nominal uncompressed block size; blocks always end on a record
+# boundary, so they run slightly over.
+BLOCK_SIZE = 1 << 20
+
+
+class TraceStoreWriter:
+    """Builds a store incrementally from normalized records.
+
+    Feed it each record as it leaves the run folder; blocks are flushed
+    as they fill, so memory stays bounded by one block regardless of
+    trace length. The per-type counts and function table for the footer
+    summary accumulate on the same pass.
+    """
+
+    def __init__(self, path, block_size=BLOCK_SIZE):
+        self.path = path
+        self.block_size = block_size
+        self._f = open(path, "wb")
+        self._f.write(MAGIC)
+        self._offset = len(MAGIC)
+        self._pending = []           # serialized record lines
+        self._pending_bytes = 0
+        self._records = 0
+        self._blocks = []            # [offset, clen, rec_start, rec_end]
+        self._counts = {}
+        self._functions = {}
+
+    def append(self, record):
+        line = json.dumps(record, separators=(",", ":")).encode()
+        self._pending.append(line)
+        self._pending_bytes += len(line) + 1
+        self._records += 1
+
+        record_type = record.get("type", "UNKNOWN")
+        self._counts[record_type] = self._counts.get(record_type, 0) + 1
+        if record_type == "CALL":
+            name = record.get("subject")
+            entry = self._functions.get(name)
+            if entry is None:
+                self._functions[name] = {
+                    "name": name, "calls": 1, "first_event": record.get("id")
+                }
+            else:
+                entry["calls"] += 1
+
+        if self._pending_bytes >= self.block_size:
+            self._flush_block()
+
+    def _flush_block(self):
+        raw = b"\n".join(self._pending) + b"\n"
+        compressed = zlib.compress(raw)
+        rec_start = self._blocks[-1][3] if self._blocks else 0
+        self._blocks.append(
+            [self._offset, len(compressed), rec_start, self._records]
+        )
+        self._f.write(compressed)
+        self._offset += len(compressed)
+        self._pending = []
+        self._pending_bytes = 0
+
+    def close(self, metadata=None, seed=None, success=None, error=None):
+        """Seal the store once the run's outcome is known — the summary
+        lands in the footer so serving it never decodes a block."""
+        if self._pending:
+            self._flush_block()
+        footer = json.dumps({
+            "blocks": self._blocks,
+            "total_records": self._records,
+            "summary": {
+                "metadata": metadata or {},
+                "seed": seed,
+                "success": success,
+                "error": error,
+                "total_events": self._records,
+                "counts": self._counts,
+                "functions": sorted(
+                    self._functions.values(),
+                    key=lambda fn: fn["first_event"] or 0,
+                ),
+            },
+        }).encode()
+        self._f.write(footer)
+        self._f.write(_TRAILER.pack(self._offset))
+        self._f.write(MAGIC)
+        self._f.close()
+
+    def abort(self):
+        """Drop the partial store (normalize failed mid-stream)."""
+        self._f.close()
+        try:
+            os.remove(self.path)
+        except OSError:
+            pass
+
+    @property
+    def total_records(self):
+        return self._records
+
+
+class TraceStore:
+    """Random access to a stored trace by record range."""
+
+    def __init__(self, path):
+        self.path = path
+        self._f = open(path, "rb")
+        size = os.fstat(self._f.fileno()).st_size
+        tail = _TRAILER.size + len(MAGIC)
+        if size < len(MAGIC) + tail:
+            raise ValueError(f"Not a trace store (too short): {path}")
+        self._mm = mmap.mmap(self._f.fileno(), 0, access=mmap.ACCESS_READ)
+        if self._mm[: len(MAGIC)] != MAGIC or self._mm[-len(MAGIC):] != MAGIC:
+            raise ValueError(f"Not a trace store (bad magic): {path}")
+        (footer_offset,) = _TRAILER.unpack(
+            self._mm[size - tail: size - len(MAGIC)]
+        )
+        footer = json.loads(self._mm[footer_offset: size - tail])
+        self.blocks = footer["blocks"]
+        self.total_records = footer["total_records"]
+        self.summary = footer["summary"]
+
+    def records(self, start=0, count=None):
+        """Yield records [start, start+count) — only the blocks that
+        overlap the range are inflated."""
+        stop = self.total_records if count is None else min(
+            start + count, self.total_records
+        )
+        for offset, clen, rec_start, rec_end in self.blocks:
+            if rec_end <= start:
+                continue
+            if rec_start >= stop:
+                break
+            raw = zlib.decompress(self._mm[offset: offset + clen])
+            for i, line in enumerate(raw.splitlines(), start=rec_start):
+                if i >= stop:
+                    return
+                if i >= start:
+                    yield json.loads(line)
+
+    def iter_records(self):
+        """All records, block by block."""
+        return self.records(0, None)
+
+    def close(self):
+        self._mm.close()
+        self._f.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
@@ -11,12 +11,21 @@ Usage:
 Then open http://localhost:5000 in your browser.
 """
 
+import gzip
+import hashlib
 import os
 import json
+import shutil
 import sys
 import tempfile
+from concurrent.futures import ProcessPoolExecutor, as_completed
 from pathlib import Path
-from flask import Flask, send_from_directory, jsonify, abort, request
+from flask import Flask, Response, send_from_directory, jsonify, abort, request
+
+try:
+    import brotli  # optional: better ratios when available
+except ImportError:
+    brotli = None
 
 app = Flask(__name__)
 
@@ -28,6 +37,376 @@ JSON_DIR   = os.path.join(DATA_DIR, "json")
 PARSER_DIR = os.path.join(BASE_DIR, "parser")
 TESTS_DIR  = os.path.join(PARSER_DIR, "tests")
 
+# ── worker pool for batch processing ─────────────────────────────────
+# Each file's instrument→compile→run→normalize pipeline is CPU-bound and
+# independent, so batches fan out across processes instead of running
+# serially inside the request handler.
+MAX_WORKERS = int(os.environ.get("PROCESS_WORKERS", min(os.cpu_count() or 4, 8)))
+
+_pool = None
+
+
+def _get_pool():
+    global _pool
+    if _pool is None:
+        _pool = ProcessPoolExecutor(max_workers=MAX_WORKERS)
+    return _pool
+
+
+def _process_one(filename):
+    """Run the full pipeline for one file from data/ (executes in a worker).
+
+    Returns ("result", entry, timings) or ("error", entry, timings); the
+    entry shapes match what /api/process has always put in its
+    results/errors arrays, and timings is deal()'s stage-timing dict
+    (None when the pipeline never ran) for the parent's metrics registry.
+    """
+    if "/" in filename or "\\" in filename or ".." in filename:
+        return ("error", {"file": filename, "stage": "validation", "message": "Invalid filename"}, None)
+
+    input_path = os.path.join(DATA_DIR, filename)
+    if not os.path.isfile(input_path):
+        return ("error", {"file": filename, "stage": "validation", "message": "File not found"}, None)
+
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from run import deal
+
+    timings = {}
+    try:
+        os.makedirs(JSON_DIR, exist_ok=True)
+        save_name = f"{os.path.splitext(filename)[0]}.json"
+        save_path = os.path.join(JSON_DIR, save_name)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            output_path = os.path.join(tmpdir, f"{os.path.splitext(filename)[0]}.json")
+
+            deal(input_path, output=output_path, seed=-1, timings=timings)
+
+            with open(output_path) as f:
+                result = json.load(f)
+            _retain_trace_store(input_path, save_path)
+
+        # ALWAYS include the result for visualization, even with no traces
+        # The frontend error panel will display compile/runtime errors
+        body = json.dumps(result, indent=2)
+        with open(save_path, "w") as f:
+            f.write(body)
+        _precompress_trace(save_path, body.encode())
+
+        is_success = result.get("success", False)
+        return ("result", {
+            "file": filename,
+            "output": save_name,
+            "success": is_success,
+            "data": result,
+            "warning": result.get("error", {}).get("message") if not is_success else None
+        }, timings)
+    except Exception as e:
+        return ("error", {"file": filename, "stage": "processing", "message": str(e)}, timings)
+
+
+def _retain_trace_store(input_path, save_path):
+    """Keep the pipeline's record store next to the stored JSON.
+
+    deal() writes the store with its other derived artifacts in the
+    output/ folder beside the *input* file (see run._derived_paths), not
+    beside the JSON we asked for — so resolve it from the input path and
+    move it in as a `.trcs` sidecar (like `.gz`/`.etag`), letting the
+    windowed endpoints inflate only the blocks a request touches instead
+    of parsing the whole JSON. Absent store (Python/text runs) just
+    means those endpoints fall back to the parsed-JSON path.
+    """
+    from run import _derived_paths
+
+    store_path = _derived_paths(input_path)["trace_store"]
+    if os.path.isfile(store_path):
+        shutil.move(store_path, save_path + ".trcs")
+        return
+    # No store this run (Python/text pipeline) — drop any sidecar a
+    # previous run of the same file left, or the endpoints would serve
+    # stale records.
+    try:
+        os.remove(save_path + ".trcs")
+    except OSError:
+        pass
+
+
+def _observe_pipeline(timings, success):
+    """Fold one pipeline run's timings into the metrics registry."""
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from metrics import REGISTRY
+    REGISTRY.observe(timings, success=success)
+
+
+# ── trace store: windowed access to stored results ───────────────────
+# Normalized results live in JSON_DIR; large traces shouldn't force the
+# browser to download and parse the whole file before the first spiral
+# turn appears. Server-processed traces keep the pipeline's
+# block-indexed record store as a `.trcs` sidecar, so summaries come
+# from its footer and slices inflate only the touched blocks; traces
+# without one fall back to a small in-memory cache of parsed JSONs
+# (mtime-checked).
+_TRACE_CACHE_MAX = 4
+
+_trace_cache = {}  # name -> {"mtime": float, "data": dict, "summary": dict}
+
+
+def _trace_path(trace_id):
+    """Resolve a trace id to its stored JSON path, or None if invalid."""
+    if "/" in trace_id or "\\" in trace_id or ".." in trace_id:
+        return None
+    name = trace_id if trace_id.endswith(".json") else f"{trace_id}.json"
+    path = os.path.join(JSON_DIR, name)
+    return path if os.path.isfile(path) else None
+
+
+def _precompress_trace(path, body=None):
+    """Write the ETag and compressed sidecars for a stored trace.
+
+    Done once at save time so serving never hashes or deflates a
+    multi-megabyte trace inside a request. Sidecars sit next to the
+    JSON (`x.json.etag`, `x.json.gz`, optionally `x.json.br`) and are
+    considered stale whenever the JSON is newer. Returns the etag.
+    """
+    if body is None:
+        with open(path, "rb") as f:
+            body = f.read()
+    etag = hashlib.sha256(body).hexdigest()[:32]
+    with open(path + ".etag", "w") as f:
+        f.write(etag)
+    with gzip.open(path + ".gz", "wb", compresslevel=6) as f:
+        f.write(body)
+    if brotli is not None:
+        with open(path + ".br", "wb") as f:
+            f.write(brotli.compress(body, quality=5))
+    return etag
+
+
+def _trace_etag(path):
+    """The stored trace's content-hash ETag, regenerating stale sidecars."""
+    sidecar = path + ".etag"
+    try:
+        if os.path.getmtime(sidecar) >= os.path.getmtime(path):
+            with open(sidecar) as f:
+                return f.read().strip()
+    except OSError:
+        pass
+    # Missing or older than the JSON (e.g. written by an older run of the
+    # pipeline) — rebuild everything from the current content.
+    return _precompress_trace(path)
+
+
+def _resolve_field(value, strings):
+    """Map a v2 interned field index back to its string."""
+    if isinstance(value, int) and strings is not None and 0 <= value < len(strings):
+        return strings[value]
+    return value
+
+
+# Open record stores (mmap handles are cheap to keep; mtime-checked so a
+# re-processed file swaps its store in).
+_store_cache = {}  # name -> {"mtime": float, "store": TraceStore}
+
+
+def _trace_store(trace_id):
+    """The trace's block-indexed record store, or None without one.
+
+    When the sidecar exists, summary and slice requests are served from
+    it — the summary straight from the footer, slices by inflating only
+    the overlapping blocks — instead of parsing the whole JSON.
+    """
+    path = _trace_path(trace_id)
+    if path is None:
+        return None
+    store_path = path + ".trcs"
+    try:
+        mtime = os.path.getmtime(store_path)
+    except OSError:
+        return None
+
+    cached = _store_cache.get(trace_id)
+    if cached and cached["mtime"] == mtime:
+        return cached["store"]
+
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from tracestore import TraceStore
+    try:
+        store = TraceStore(store_path)
+    except (ValueError, OSError):
+        return None  # truncated or pre-rewrite store — use the JSON
+
+    if cached:
+        cached["store"].close()
+    elif len(_store_cache) >= _TRACE_CACHE_MAX:
+        _store_cache.pop(next(iter(_store_cache)))["store"].close()
+    _store_cache[trace_id] = {"mtime": mtime, "store": store}
+    return store
+
+
+def _load_trace(trace_id):
+    """Load a stored trace (cached), returning {"data": …, "summary": …}."""
+    path = _trace_path(trace_id)
+    if path is None:
+        return None
+
+    mtime = os.path.getmtime(path)
+    cached = _trace_cache.get(trace_id)
+    if cached and cached["mtime"] == mtime:
+        return cached
+
+    with open(path) as f:
+        data = json.load(f)
+
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from normalize import INTERNED_FIELDS
+
+    strings = data.get("strings") if data.get("version") == 2 else None
+    traces = data.get("traces", [])
+
+    # One pass over the records builds everything the summary needs:
+    # per-type counts and a function table (call counts + first event).
+    counts = {}
+    functions = {}
+    for t in traces:
+        trace_type = t.get("type", "UNKNOWN")
+        counts[trace_type] = counts.get(trace_type, 0) + 1
+        if trace_type == "CALL":
+            name = _resolve_field(t.get("subject"), strings)
+            entry = functions.get(name)
+            if entry is None:
+                functions[name] = {"name": name, "calls": 1, "first_event": t.get("id")}
+            else:
+                entry["calls"] += 1
+
+    summary = {
+        "metadata": data.get("metadata", {}),
+        "seed": data.get("seed"),
+        "success": data.get("success"),
+        "error": data.get("error"),
+        "total_events": len(traces),
+        "counts": counts,
+        "functions": sorted(functions.values(), key=lambda fn: fn["first_event"] or 0),
+    }
+
+    entry = {"mtime": mtime, "data": data, "summary": summary,
+             "strings": strings, "interned_fields": INTERNED_FIELDS}
+    if len(_trace_cache) >= _TRACE_CACHE_MAX and trace_id not in _trace_cache:
+        _trace_cache.pop(next(iter(_trace_cache)))
+    _trace_cache[trace_id] = entry
+    return entry
+
+
+@app.route("/api/traces")
+def list_traces():
+    """List stored trace JSON files."""
+    if not os.path.isdir(JSON_DIR):
+        return jsonify([])
+    files = sorted(f for f in os.listdir(JSON_DIR) if f.endswith(".json"))
+    return jsonify(files)
+
+
+@app.route("/api/trace/<trace_id>")
+def get_trace(trace_id):
+    """Serve a full stored trace JSON (legacy path — prefer summary+slice).
+
+    Responses carry a strong content-hash ETag; a matching If-None-Match
+    short-circuits to 304, and clients that accept br/gzip get the
+    precompressed sidecar, so repeat loads of an unchanged trace cost
+    kilobytes instead of the full JSON.
+    """
+    path = _trace_path(trace_id)
+    if path is None:
+        abort(404)
+
+    etag = _trace_etag(path)
+    headers = {
+        "ETag": f'"{etag}"',
+        # no-cache = revalidate every time, which the ETag makes cheap.
+        "Cache-Control": "no-cache",
+        "Vary": "Accept-Encoding",
+    }
+
+    if etag in (request.if_none_match or ()):
+        return Response(status=304, headers=headers)
+
+    accepted = request.accept_encodings
+    mtime = os.path.getmtime(path)
+    for encoding, suffix in (("br", ".br"), ("gzip", ".gz")):
+        sidecar = path + suffix
+        if (accepted.quality(encoding) > 0 and os.path.isfile(sidecar)
+                and os.path.getmtime(sidecar) >= mtime):
+            response = send_from_directory(
+                JSON_DIR, os.path.basename(sidecar), mimetype="application/json")
+            response.headers["Content-Encoding"] = encoding
+            response.headers.update(headers)
+            return response
+
+    response = send_from_directory(JSON_DIR, os.path.basename(path))
+    response.headers.update(headers)
+    return response
+
+
+@app.route("/api/trace/<trace_id>/summary")
+def get_trace_summary(trace_id):
+    """Metadata, per-type counts and function table — no trace records.
+
+    Served from the record store's footer when one exists (no block is
+    ever inflated); otherwise computed from the parsed JSON.
+    """
+    store = _trace_store(trace_id)
+    if store is not None:
+        return jsonify(store.summary)
+    entry = _load_trace(trace_id)
+    if entry is None:
+        abort(404)
+    return jsonify(entry["summary"])
+
+
+@app.route("/api/trace/<trace_id>/slice")
+def get_trace_slice(trace_id):
+    """A window of trace records: ?start=<index>&count=<n>.
+
+    Interned v2 fields are resolved server-side so the client never needs
+    the full string table for a window. With a record store alongside,
+    only the compressed blocks overlapping the window are inflated (the
+    store keeps records pre-interning, so nothing needs resolving).
+    """
+    try:
+        start = max(0, int(request.args.get("start", 0)))
+        count = max(0, int(request.args.get("count", 1000)))
+    except ValueError:
+        return jsonify({"success": False,
+                        "error": {"stage": "request", "message": "start and count must be integers"}}), 400
+
+    store = _trace_store(trace_id)
+    if store is not None:
+        window = list(store.records(start, count))
+        return jsonify({"start": start, "count": len(window),
+                        "total": store.total_records, "traces": window})
+
+    entry = _load_trace(trace_id)
+    if entry is None:
+        abort(404)
+
+    traces = entry["data"].get("traces", [])
+    total = len(traces)
+    window = traces[start:start + count]
+    strings = entry["strings"]
+    if strings is not None:
+        resolved = []
+        for t in window:
+            t = dict(t)
+            for field in entry["interned_fields"]:
+                if isinstance(t.get(field), int):
+                    t[field] = _resolve_field(t[field], strings)
+            resolved.append(t)
+        window = resolved
+
+    return jsonify({"start": start, "count": len(window), "total": total, "traces": window})
+
 
 # ── API: serve code files ────────────────────────────────────────────
 
@@ -95,12 +474,14 @@ def process_file():
         out_path = os.path.join(tmpdir, f"{stem}.json")
 
         # Run the full pipeline: instrument → compile → run → normalize
-        return_code = deal(src_path, output=out_path, seed=-1)
+        timings = {}
+        return_code = deal(src_path, output=out_path, seed=-1, timings=timings)
 
         # Read the result
         with open(out_path) as f:
             result = json.load(f)
 
+    _observe_pipeline(timings, result.get("success", False))
     return jsonify(result)
 
 
@@ -121,62 +502,20 @@ def process_code_files():
             "error": {"stage": "request", "message": "Files must be a non-empty array"}
         }), 400
 
-    # Add parser directory to path
-    if PARSER_DIR not in sys.path:
-        sys.path.insert(0, PARSER_DIR)
-
-    from run import deal
+    # Fan the batch out across the worker pool; responses keep the
+    # request's file order regardless of completion order.
+    pool = _get_pool()
+    futures = {filename: pool.submit(_process_one, filename) for filename in files}
 
     results = []
     errors = []
-
     for filename in files:
-        # Security check
-        if "/" in filename or "\\" in filename or ".." in filename:
-            errors.append({"file": filename, "stage": "validation", "message": "Invalid filename"})
-            continue
-
-        input_path = os.path.join(DATA_DIR, filename)
-        if not os.path.isfile(input_path):
-            errors.append({"file": filename, "stage": "validation", "message": "File not found"})
-            continue
-
-        # Process the file
-        try:
-            with tempfile.TemporaryDirectory() as tmpdir:
-                output_path = os.path.join(tmpdir, f"{os.path.splitext(filename)[0]}.json")
-                
-                # Run the parser
-                return_code = deal(input_path, output=output_path, seed=-1)
-                
-                # Read the result
-                with open(output_path) as f:
-                    result = json.load(f)
-
-                # ALWAYS include the result for visualization, even with no traces
-                # The frontend error panel will display compile/runtime errors
-                # Save to data/json directory
-                os.makedirs(JSON_DIR, exist_ok=True)
-                save_name = f"{os.path.splitext(filename)[0]}.json"
-                save_path = os.path.join(JSON_DIR, save_name)
-                with open(save_path, "w") as f:
-                    json.dump(result, f, indent=2)
-                
-                is_success = result.get("success", False)
-                results.append({
-                    "file": filename,
-                    "output": save_name,
-                    "success": is_success,
-                    "data": result,  # Include result regardless of success or traces
-                    "warning": result.get("error", {}).get("message") if not is_success else None
-                })
-
-        except Exception as e:
-            errors.append({
-                "file": filename,
-                "stage": "processing",
-                "message": str(e)
-            })
+        kind, entry, timings = futures[filename].result()
+        _observe_pipeline(timings, kind == "result" and entry.get("success", False))
+        if kind == "result":
+            results.append(entry)
+        else:
+            errors.append(entry)
 
     # Return results - always return 200 if we have any results (even with warnings)
     # This allows visualization to proceed even with runtime errors
@@ -195,6 +534,182 @@ def process_code_files():
     }), 400
 
 
+@app.route("/api/process-stream", methods=["POST"])
+def process_code_files_stream():
+    """Like /api/process, but streams per-file completion events (SSE).
+
+    Each finished file arrives as a `data:` event the moment its pipeline
+    completes, so the galaxy view can start rendering early files while
+    the rest are still compiling. A final `done` event carries the totals.
+
+    Result entries carry the stored trace id ("output") but not the
+    records themselves — the client fetches windows from
+    /api/trace/<id>/slice, keeping each event a few hundred bytes.
+    """
+    data = request.get_json()
+    if not data or "files" not in data:
+        return jsonify({
+            "success": False,
+            "error": {"stage": "request", "message": "No files specified"}
+        }), 400
+
+    files = data["files"]
+    if not isinstance(files, list) or len(files) == 0:
+        return jsonify({
+            "success": False,
+            "error": {"stage": "request", "message": "Files must be a non-empty array"}
+        }), 400
+
+    pool = _get_pool()
+    futures = {pool.submit(_process_one, filename): filename for filename in files}
+
+    def generate():
+        processed = 0
+        failed = 0
+        for future in as_completed(futures):
+            kind, entry, timings = future.result()
+            _observe_pipeline(timings, kind == "result" and entry.get("success", False))
+            if kind == "result":
+                processed += 1
+                entry = {k: v for k, v in entry.items() if k != "data"}
+            else:
+                failed += 1
+            yield f"data: {json.dumps({'kind': kind, 'entry': entry})}\n\n"
+        totals = {"processed": processed, "failed": failed, "total": len(futures)}
+        yield f"event: done\ndata: {json.dumps(totals)}\n\n"
+
+    return Response(generate(), mimetype="text/event-stream",
+                    headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"})
+
+
+# ── API: async jobs ──────────────────────────────────────────────────
+# /api/process-file runs the whole pipeline inside the request handler,
+# so a slow program holds a Flask worker for its full timeout. The job
+# routes decouple that: submission returns an id immediately, the queue's
+# worker threads run the pipeline, and the client polls the status route
+# or subscribes to the SSE feed for stage-by-stage progress.
+
+def _submit_pipeline_job(file):
+    """Validate the upload and enqueue its pipeline run; returns a
+    (response, status) pair ready to return from the route."""
+    if not file.filename:
+        return jsonify({"success": False, "error": {"stage": "upload", "message": "No file selected"}}), 400
+
+    ext = os.path.splitext(file.filename)[1].lower()
+    if ext not in (".c", ".py"):
+        return jsonify({"success": False, "error": {"stage": "upload", "message": f"Unsupported file type '{ext}'. Only .c and .py files are accepted."}}), 400
+
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from jobs import QUEUE
+
+    # The request body is gone once the handler returns — read it now,
+    # the worker thread writes its own copy.
+    filename = os.path.basename(file.filename)
+    src_bytes = file.read()
+
+    def run_job(progress):
+        from run import deal
+
+        timings = {}
+        os.makedirs(JSON_DIR, exist_ok=True)
+        save_name = f"{os.path.splitext(filename)[0]}.json"
+        save_path = os.path.join(JSON_DIR, save_name)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            src_path = os.path.join(tmpdir, filename)
+            with open(src_path, "wb") as f:
+                f.write(src_bytes)
+            out_path = os.path.join(tmpdir, f"{os.path.splitext(filename)[0]}.json")
+            deal(src_path, output=out_path, seed=-1,
+                 timings=timings, progress=progress)
+            with open(out_path) as f:
+                result = json.load(f)
+            _retain_trace_store(src_path, save_path)
+
+        # Store the full result like /api/process does and hand the
+        # client a trace id instead of the records: it pulls windows
+        # from /api/trace/<id>/slice, so the job result (and the SSE
+        # event carrying it) stays small no matter how big the trace is.
+        body = json.dumps(result, indent=2)
+        with open(save_path, "w") as f:
+            f.write(body)
+        _precompress_trace(save_path, body.encode())
+
+        _observe_pipeline(timings, result.get("success", False))
+        return {
+            "success": result.get("success", False),
+            "error": result.get("error"),
+            "seed": result.get("seed"),
+            "metadata": result.get("metadata", {}),
+            "trace_id": save_name,
+            "total_events": len(result.get("traces", [])),
+        }
+
+    job_id = QUEUE.submit(run_job, label=filename)
+    return jsonify({"job_id": job_id}), 202
+
+
+def _job_public_state(snapshot, with_result):
+    state = {k: snapshot[k] for k in
+             ("id", "label", "state", "stage", "stages_done", "error")}
+    if with_result and snapshot["state"] == "done":
+        state["result"] = snapshot["result"]
+    return state
+
+
+@app.route("/api/jobs", methods=["POST"])
+def submit_job():
+    """Enqueue pipeline processing for an uploaded file (async
+    /api/process-file); responds immediately with the job id."""
+    if "file" not in request.files:
+        return jsonify({"success": False, "error": {"stage": "upload", "message": "No file provided"}}), 400
+    return _submit_pipeline_job(request.files["file"])
+
+
+@app.route("/api/jobs/<job_id>")
+def job_status(job_id):
+    """Job state for polling clients; carries the result once done."""
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from jobs import QUEUE
+    snapshot = QUEUE.status(job_id)
+    if snapshot is None:
+        abort(404)
+    return jsonify(_job_public_state(snapshot, with_result=True))
+
+
+@app.route("/api/jobs/<job_id>/events")
+def job_events(job_id):
+    """SSE feed of the job's stage transitions.
+
+    One `data:` event per transition (result only on the final one, so
+    progress events stay tiny), ending when the job is done or failed.
+    """
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from jobs import QUEUE
+    if QUEUE.status(job_id) is None:
+        abort(404)
+
+    def generate():
+        for snapshot in QUEUE.events(job_id):
+            terminal = snapshot["state"] in ("done", "error")
+            yield f"data: {json.dumps(_job_public_state(snapshot, with_result=terminal))}\n\n"
+
+    return Response(generate(), mimetype="text/event-stream",
+                    headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"})
+
+
+@app.route("/api/metrics")
+def get_metrics():
+    """Pipeline stage timings and sizes, Prometheus text format."""
+    if PARSER_DIR not in sys.path:
+        sys.path.insert(0, PARSER_DIR)
+    from metrics import REGISTRY
+    return Response(REGISTRY.render(),
+                    mimetype="text/plain; version=0.0.4; charset=utf-8")
+
+
 # ── Static files: serve the front-end ────────────────────────────────
 
 @app.route("/")
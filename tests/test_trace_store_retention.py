@@ -0,0 +1,109 @@
+"""Tests for the server's `.trcs` sidecar retention.
+
+deal() writes the record store with its other derived artifacts in the
+output/ folder beside the input file (run._derived_paths), while the
+server stores its JSON somewhere else entirely — these tests pin down
+that _retain_trace_store bridges the two: the store ends up beside the
+saved JSON, and a storeless re-run drops a stale sidecar.
+
+Run with:  python3 -m unittest discover tests
+"""
+
+import os
+import sys
+import tempfile
+import types
+import unittest
+
+BASE_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+PARSER_DIR = os.path.join(BASE_DIR, "parser")
+for p in (BASE_DIR, PARSER_DIR):
+    if p not in sys.path:
+        sys.path.insert(0, p)
+
+try:
+    import flask  # noqa: F401
+except ImportError:
+    # The retention helper never touches Flask — stub just enough of it
+    # that `import server` works where flask isn't installed.
+    stub = types.ModuleType("flask")
+
+    class _App:
+        def __init__(self, name):
+            pass
+
+        def route(self, *args, **kwargs):
+            def deco(fn):
+                return fn
+            return deco
+
+    stub.Flask = _App
+    stub.Response = object
+    stub.jsonify = stub.send_from_directory = stub.abort = lambda *a, **k: None
+    stub.request = None
+    sys.modules["flask"] = stub
+
+try:
+    import tree_sitter  # noqa: F401
+except ImportError:
+    # run.py and the tracer languages only bind these names at import
+    # time; nothing in the retention path ever parses source.
+    for name in ("tree_sitter", "tree_sitter_c", "tree_sitter_python"):
+        mod = types.ModuleType(name)
+        mod.Language = mod.Parser = object
+        mod.language = lambda: None
+        sys.modules[name] = mod
+
+import server  # noqa: E402
+from run import _derived_paths  # noqa: E402
+from tracestore import TraceStore, TraceStoreWriter  # noqa: E402
+
+
+class RetainTraceStoreTest(unittest.TestCase):
+    def setUp(self):
+        self._tmp = tempfile.TemporaryDirectory()
+        self.addCleanup(self._tmp.cleanup)
+        self.input_dir = os.path.join(self._tmp.name, "data")
+        self.json_dir = os.path.join(self._tmp.name, "json")
+        os.makedirs(self.input_dir)
+        os.makedirs(self.json_dir)
+        self.input_path = os.path.join(self.input_dir, "prog.c")
+        with open(self.input_path, "w") as f:
+            f.write("int main(void) { return 0; }\n")
+        self.save_path = os.path.join(self.json_dir, "prog.json")
+
+    def _write_store(self):
+        """Put a real store where deal() would leave one for this input."""
+        store_path = _derived_paths(self.input_path)["trace_store"]
+        writer = TraceStoreWriter(store_path)
+        writer.append({"type": "CALL", "subject": "main", "id": 0})
+        writer.append({"type": "RETURN", "subject": "", "id": 1})
+        writer.close(metadata={"file_name": "prog.c"}, seed=7, success=True)
+        return store_path
+
+    def test_store_moves_beside_saved_json(self):
+        store_path = self._write_store()
+        server._retain_trace_store(self.input_path, self.save_path)
+
+        sidecar = self.save_path + ".trcs"
+        self.assertTrue(os.path.isfile(sidecar))
+        self.assertFalse(os.path.exists(store_path))
+        with TraceStore(sidecar) as store:
+            self.assertEqual(store.total_records, 2)
+            self.assertEqual(store.summary["seed"], 7)
+
+    def test_storeless_run_drops_stale_sidecar(self):
+        self._write_store()
+        server._retain_trace_store(self.input_path, self.save_path)
+        # Re-run of the same file without a store (e.g. the Python
+        # pipeline) must not leave the old records being served.
+        server._retain_trace_store(self.input_path, self.save_path)
+        self.assertFalse(os.path.exists(self.save_path + ".trcs"))
+
+    def test_no_store_and_no_sidecar_is_a_no_op(self):
+        server._retain_trace_store(self.input_path, self.save_path)
+        self.assertFalse(os.path.exists(self.save_path + ".trcs"))
+
+
+if __name__ == "__main__":
+    unittest.main()